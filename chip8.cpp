@@ -1,15 +1,19 @@
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <random>
 #include "chip8.hpp"
+#include "profile.hpp"
 
+// Initialize the CHIP-8, Seeding the RNG with the Current Time
+Chip8::Chip8() : Chip8(std::chrono::system_clock::now().time_since_epoch().count()) {}
 /*
-    Initialize the CHIP-8
-    Seed the RNG with the current time, load the fontset into memoery, setup random bytes, and initialize the function table.
+    Initialize the CHIP-8 with a Fixed RNG Seed for Reproducible Runs
+    Seed the RNG, load the fontset into memoery, setup random bytes, and initialize the function table.
 */
-Chip8::Chip8() : randomGenerator(std::chrono::system_clock::now().time_since_epoch().count()) {
+Chip8::Chip8(unsigned int seed) : randomGenerator(seed) {
     /*
         Initialize the program counter to 0x200
         This where all instructions will begin as the ROM contents will be loaded from here
@@ -18,11 +22,21 @@ Chip8::Chip8() : randomGenerator(std::chrono::system_clock::now().time_since_epo
     programCounter = ROM_START_ADDRESS;
 
     // Load fonts into memory from 0x050
-    for(unsigned int i = 0; i < FONTSET_LENGTH; i++)
+    for(unsigned int i = 0; i < static_cast<unsigned int>(FONTSET_LENGTH); i++)
         memory[FONTSET_START_ADDRESS + i] = fontset[i];
 
     randomByte = std::uniform_int_distribution<uint8_t>(0, 255u);
 
+    // Point every slot at the dummy function so undefined opcodes do nothing
+    for(Chip8Function& function : functionTable0)
+        function = &Chip8::op_NULL;
+    for(Chip8Function& function : functionTable8)
+        function = &Chip8::op_NULL;
+    for(Chip8Function& function : functionTableE)
+        function = &Chip8::op_NULL;
+    for(Chip8Function& function : functionTableF)
+        function = &Chip8::op_NULL;
+
     // Setup Function Pointer Table
     functionTable[0x00] = &Chip8::functionTableWrapper0;
     functionTable[0x01] = &Chip8::op_1nnn;
@@ -57,15 +71,15 @@ Chip8::Chip8() : randomGenerator(std::chrono::system_clock::now().time_since_epo
     functionTableE[0x01] = &Chip8::op_ExA1;
     functionTableE[0x0E] = &Chip8::op_Ex9E;
 
-    functionTable8[0x07] = &Chip8::op_Fx07;
-    functionTable8[0x0A] = &Chip8::op_Fx0A;
-    functionTable8[0x15] = &Chip8::op_Fx15;
-    functionTable8[0x18] = &Chip8::op_Fx18;
-    functionTable8[0x1E] = &Chip8::op_Fx1E;
-    functionTable8[0x29] = &Chip8::op_Fx29;
-    functionTable8[0x33] = &Chip8::op_Fx33;
-    functionTable8[0x55] = &Chip8::op_Fx55;
-    functionTable8[0x65] = &Chip8::op_Fx65;
+    functionTableF[0x07] = &Chip8::op_Fx07;
+    functionTableF[0x0A] = &Chip8::op_Fx0A;
+    functionTableF[0x15] = &Chip8::op_Fx15;
+    functionTableF[0x18] = &Chip8::op_Fx18;
+    functionTableF[0x1E] = &Chip8::op_Fx1E;
+    functionTableF[0x29] = &Chip8::op_Fx29;
+    functionTableF[0x33] = &Chip8::op_Fx33;
+    functionTableF[0x55] = &Chip8::op_Fx55;
+    functionTableF[0x65] = &Chip8::op_Fx65;
 }
 
 // Loads a ROM into memoery at the START_ADDRESS
@@ -90,9 +104,16 @@ void Chip8::loadROM(const char* path) {
             Load the contents of the rom into memory by taking each character in the buffer and setting it to each memory address, beginning with 0x200
             0x000 to 0x1FF is reserved for system functions, so all ROM data is stored after that
         */
-        for(long i = 0; i < size; i++)
+        for(long i = 0; i < size && i < static_cast<long>(sizeof(memory) - ROM_START_ADDRESS); i++)
             memory[ROM_START_ADDRESS + i] = buffer[i];
 
+        // Hash the image so saved profiles can tell which ROM they were recorded from
+        romHash = 0xCBF29CE484222325u;
+        for(long i = 0; i < size; i++) {
+            romHash ^= static_cast<uint8_t>(buffer[i]);
+            romHash *= 0x100000001B3u;
+        }
+
         // Delete the buffer
         delete[] buffer;
     }
@@ -100,7 +121,12 @@ void Chip8::loadROM(const char* path) {
 // Fetch, Decode, and Execute Each Instruction
 void Chip8::cycle() {
     // Fetch the next instruction and store it as the opcode
-    opcode = (memory[programCounter] << 8u) | memory[programCounter + 1];
+    // Addresses wrap at 4 KB, so a jump near the top of memory or into data can never read past it
+    opcode = (memory[programCounter & 0x0FFFu] << 8u) | memory[(programCounter + 1) & 0x0FFFu];
+    if(profile) {
+        profile->markExecute(programCounter);
+        profile->markExecute(programCounter + 1);
+    }
 
     // Increment program counter before execution 
     programCounter += 2;
@@ -118,6 +144,62 @@ void Chip8::cycle() {
     if(soundTimer > 0)
         soundTimer--;
 }
+// 64-bit FNV-1a Hash of the Video Memory
+uint64_t Chip8::videoHash() const {
+    uint64_t hash = 0xCBF29CE484222325u;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(video);
+    for(size_t i = 0; i < sizeof(video); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3u;
+    }
+    return hash;
+}
+// Copy the Running State into a Snapshot
+void Chip8::saveState(Chip8State& state) const {
+    memcpy(state.registers, registers, sizeof(registers));
+    memcpy(state.memory, memory, sizeof(memory));
+    state.index = index;
+    state.programCounter = programCounter;
+    state.opcode = opcode;
+    memcpy(state.stack, stack, sizeof(stack));
+    state.stackPointer = stackPointer;
+    state.delayTimer = delayTimer;
+    state.soundTimer = soundTimer;
+    state.keypad = keypad;
+    state.keyReleases = keyReleases;
+    state.waitingForKey = waitingForKey;
+    memcpy(state.video, video, sizeof(video));
+    state.randomGenerator = randomGenerator;
+}
+// Restore the Running State from a Snapshot
+void Chip8::loadState(const Chip8State& state) {
+    memcpy(registers, state.registers, sizeof(registers));
+    memcpy(memory, state.memory, sizeof(memory));
+    index = state.index;
+    programCounter = state.programCounter;
+    opcode = state.opcode;
+    memcpy(stack, state.stack, sizeof(stack));
+    stackPointer = state.stackPointer;
+    delayTimer = state.delayTimer;
+    soundTimer = state.soundTimer;
+    keypad = state.keypad;
+    keyReleases = state.keyReleases;
+    waitingForKey = state.waitingForKey;
+    memcpy(video, state.video, sizeof(video));
+    randomGenerator = state.randomGenerator;
+}
+// Mark a Key as Held
+void Chip8::pressKey(uint8_t key) {
+    key &= 0x0Fu;
+    keypad |= 1u << key;
+}
+// Mark a Key as Released, Waking Fx0A if it is Waiting
+void Chip8::releaseKey(uint8_t key) {
+    key &= 0x0Fu;
+    keypad &= ~(1u << key);
+    if(waitingForKey)
+        keyReleases |= 1u << key;
+}
 
 // CPU Instructions
 
@@ -130,8 +212,8 @@ void Chip8::op_00E0() {
 }
 // RET - Return from Subroutine
 void Chip8::op_00EE() {
-    // Move the stack pointer down one so it moves past the previous instruction
-    stackPointer--;
+    // Move the stack pointer down one so it moves past the previous instruction, wrapping so an unbalanced return stays in the stack
+    stackPointer = (stackPointer - 1) & 0x0Fu;
     // The make the next instruction the current program counter
     programCounter = stack[stackPointer];
 }
@@ -148,7 +230,8 @@ void Chip8::op_2nnn() {
     uint16_t address = opcode & 0x0FFFu;
 
     stack[stackPointer] = programCounter;
-    stackPointer++;
+    // Wrap so runaway recursion overwrites the oldest entry instead of running off the stack
+    stackPointer = (stackPointer + 1) & 0x0Fu;
     programCounter = address;
 }
 // SE Vx, <byte> - Skip Next Instruction if Vx = kk
@@ -256,14 +339,14 @@ void Chip8::op_8xy6() {
 }
 /*
     SUBN Vx, Vy - Set Vx = Vy - Vx, Set VF - Not Borrow
-    If Vx > Vy, then VF is set to 1, otherwise 0
+    If Vy > Vx, then VF is set to 1, otherwise 0
     Then Vx is subtracted from Vy, and result's stored in Vx
 */
 void Chip8::op_8xy7() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
     uint8_t vY = (opcode & 0x00F0u) >> 4u;
 
-    if(registers[vX] > registers[vY])
+    if(registers[vY] > registers[vX])
         registers[0x0F] = 1;
     else
         registers[0x0F] = 0;
@@ -319,12 +402,14 @@ void Chip8::op_Dxyn() {
 
     // Set VF to 0 as default
     registers[0x0F] = 0;
-    // Look through every position in the sprite
+    // Look through every position in the sprite, clipping whatever falls past the bottom or right edge
     // i is row number
-    for(unsigned int i = 0; i < height; i++) {
-        uint8_t spriteByte = memory[index + i];
+    for(unsigned int i = 0; i < height && yPosition + i < static_cast<unsigned int>(VIDEO_HEIGHT); i++) {
+        uint8_t spriteByte = memory[(index + i) & 0x0FFFu];
+        if(profile)
+            profile->markRead(index + i);
         // j is column number
-        for(unsigned int j = 0; j < SPRITE_WIDTH; j++) {
+        for(unsigned int j = 0; j < static_cast<unsigned int>(SPRITE_WIDTH) && xPosition + j < static_cast<unsigned int>(VIDEO_WIDTH); j++) {
             uint8_t spritePixel = spriteByte & (0x80u >> j);
             uint32_t* screenPixel = &video[(yPosition + i) * VIDEO_WIDTH + (xPosition + j)];
             // If the screen pixel is on
@@ -343,16 +428,18 @@ void Chip8::op_Dxyn() {
 // SKP Vx - Skip next instruction if key of value Vx is pressed
 void Chip8::op_Ex9E() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
-    uint8_t key = registers[vX];
-    if(keypad[key]) {
+    // Only the low nibble names a key; larger values would shift past the mask
+    uint8_t key = registers[vX] & 0x0Fu;
+    if(keypad & (1u << key)) {
         programCounter += 2;
     }
 }
 // SKNP Vx - Skip next instruction if key of value Vx is not pressed
 void Chip8::op_ExA1() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
-    uint8_t key = registers[vX];
-    if(!keypad[key]) {
+    // Only the low nibble names a key; larger values would shift past the mask
+    uint8_t key = registers[vX] & 0x0Fu;
+    if(!(keypad & (1u << key))) {
         programCounter += 2;
     }
 }
@@ -361,48 +448,22 @@ void Chip8::op_Fx07() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
     registers[vX] = delayTimer;
 }
-// LD Vx, L - Wait for key press, store value of key in Vx
+/*
+    LD Vx, L - Wait for key press, store value of key in Vx
+    A key counts once it has been pressed and released, so the instruction wakes on the release event
+    While no key has been released, decrement program counter by 2 as a way of "waiting"
+*/
 void Chip8::op_Fx0A() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
-    // Check every single key if pressed, if so store value to Vx
-    if(keypad[0]) {
-        registers[vX] = 0;
-    } else if(keypad[1]) {
-        registers[vX] = 1;
-    } else if(keypad[2]) {
-        registers[vX] = 2;
-    } else if(keypad[3]) {
-        registers[vX] = 3;
-    } else if(keypad[4]) {
-        registers[vX] = 4;
-    } else if(keypad[5]) {
-        registers[vX] = 5;
-    } else if(keypad[6]) {
-        registers[vX] = 6;
-    } else if(keypad[7]) {
-        registers[vX] = 7;
-    } else if(keypad[8]) {
-        registers[vX] = 8;
-    } else if(keypad[9]) {
-        registers[vX] = 9;
-    } else if(keypad[10]) {
-        registers[vX] = 10;
-    } else if(keypad[11]) {
-        registers[vX] = 11;
-    } else if(keypad[12]) {
-        registers[vX] = 12;
-    } else if(keypad[13]) {
-        registers[vX] = 13;
-    } else if(keypad[14]) {
-        registers[vX] = 14;
-    } else if(keypad[15]) {
-        registers[vX] = 15;
-    // Otherwise, decrement program counter by 2 as a way of "waiting"
+    if(keyReleases) {
+        // The lowest released key wins
+        registers[vX] = std::countr_zero(keyReleases);
+        keyReleases = 0;
+        waitingForKey = false;
     } else {
+        waitingForKey = true;
         programCounter -= 2;
     }
-
-    // Find a better way to do the above. A loop could work, but the logic of only decrementing the program once on exit is a bit whack
 }
 // LD DT, Vx - Set Delay Timer to Vx
 void Chip8::op_Fx15() {
@@ -435,30 +496,39 @@ void Chip8::op_Fx33() {
     uint8_t value = registers[vX];
 
     // Store ones digit
-    memory[index + 2] = value % 10;
+    memory[(index + 2) & 0x0FFFu] = value % 10;
     // Shave off a digit
     value /= 10;
 
     // Store tens digit
-    memory[index + 1] = value % 10;
+    memory[(index + 1) & 0x0FFFu] = value % 10;
     // Shave off a digit
     value /= 10;
 
     // Store hundred digit
-    memory[index] = value % 10;
+    memory[index & 0x0FFFu] = value % 10;
+
+    if(profile) {
+        for(uint16_t i = 0; i < 3; i++)
+            profile->markWrite(index + i);
+    }
 }
 // LD [I], Vx - Store registers V0 to Vx in memeory strating at memory location I
 void Chip8::op_Fx55() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
     for(uint8_t i = 0; i <= vX; i++) {
-        memory[index + i] = registers[i];
+        memory[(index + i) & 0x0FFFu] = registers[i];
+        if(profile)
+            profile->markWrite(index + i);
     }
 }
 // LD Vx, [I] - Read registers V0 to Vx from memory strating at memory location I
 void Chip8::op_Fx65() {
     uint8_t vX = (opcode & 0x0F00u) >> 8u;
     for(uint8_t i = 0; i <= vX; i++) {
-        registers[i] = memory[index + i];
+        registers[i] = memory[(index + i) & 0x0FFFu];
+        if(profile)
+            profile->markRead(index + i);
     }
 }
 
@@ -478,5 +548,5 @@ void Chip8::functionTableWrapperE() {
 }
 // Wraper Function for All Instruction Functions that Start with F
 void Chip8::functionTableWrapperF() {
-    ((*this).*(functionTableF[opcode & 0x000Fu]))();
+    ((*this).*(functionTableF[opcode & 0x00FFu]))();
 }
@@ -4,6 +4,26 @@
 #include <cstdint>
 #include <random>
 
+class MemoryProfile;
+
+// Snapshot of Everything That Changes While a ROM Runs; About 12 KB, Copied with Plain memcpy
+struct Chip8State {
+    uint8_t registers[16];                                              // 16 8-bit Registers
+    uint8_t memory[4096];                                               // All 4096 Bytes of Memory
+    uint16_t index;                                                     // Index Register
+    uint16_t programCounter;                                            // Adress of Next Instruction
+    uint16_t opcode;                                                    // Last Decoded Opcode
+    uint16_t stack[16];                                                 // Execution Stack
+    uint8_t stackPointer;                                               // Pointer Into Stack
+    uint8_t delayTimer;                                                 // Delay Timer
+    uint8_t soundTimer;                                                 // Sound Timer
+    uint16_t keypad;                                                    // Held Keys
+    uint16_t keyReleases;                                               // Keys Released While Fx0A Was Waiting
+    bool waitingForKey;                                                 // Is Fx0A Waiting for a Key Release?
+    uint32_t video[2048];                                               // Video Memory
+    std::default_random_engine randomGenerator;                         // Random Number Generator, so Replays Draw the Same Bytes
+};
+
 class Chip8 {
     private:
         const unsigned int ROM_START_ADDRESS = 0x200;                   // Address at which the contents of ROMs are loaded into memory
@@ -16,19 +36,21 @@ class Chip8 {
         const int CHARACTER_LENGTH = 5;                                 // Constant Length of Characters in Bytes (see fonstset for more details)
     public:
         // CPU State Information
-        uint8_t registers[16];                                          // 16 8-bit Registers
-        uint8_t memory[4096];                                           // Represents each of the 4096 bytes of memory
-        uint16_t index;                                                 // Index register for storing memory addresses for aperations
+        uint8_t registers[16] {};                                       // 16 8-bit Registers
+        uint8_t memory[4096] {};                                        // Represents each of the 4096 bytes of memory
+        uint16_t index = 0;                                             // Index register for storing memory addresses for aperations
         uint16_t programCounter;                                        // Adress of Next Instruction
-        uint16_t opcode;                                                // An encoded form of the operation and relevant data as a number
-        uint16_t stack[16];                                             // Execution Stack
-        uint8_t stackPointer;                                           // Pointer Into Stack
-        uint8_t delayTimer;                                             // Controls Timing of CPU Cycles
+        uint16_t opcode = 0;                                            // An encoded form of the operation and relevant data as a number
+        uint16_t stack[16] {};                                          // Execution Stack
+        uint8_t stackPointer = 0;                                       // Pointer Into Stack
+        uint8_t delayTimer = 0;                                         // Controls Timing of CPU Cycles
         
         // I/O State Information
-        uint8_t soundTimer;                                             // Controls Timing of Sound
-        uint8_t keypad[16];                                             // The CHIP-8 has 16 Input Keys which are represented by 0x0 to 0xF
-        uint32_t video[2048];                                           // Video memory for a display 64 pixels wide * 32 pixels tall
+        uint8_t soundTimer = 0;                                         // Controls Timing of Sound
+        uint16_t keypad = 0;                                            // The CHIP-8 has 16 Input Keys which are represented by 0x0 to 0xF; Bit n is Set While Key n is Held
+        uint16_t keyReleases = 0;                                       // Keys Released While Fx0A Was Waiting; Bit n is Set Once Key n is Released
+        bool waitingForKey = false;                                     // Is Fx0A Waiting for a Key Release?
+        uint32_t video[2048] {};                                        // Video memory for a display 64 pixels wide * 32 pixels tall
         uint8_t fontset[80] = {                                         // 80 bytes that represents all the chracters the screen can display
             0xF0, 0x90, 0x90, 0x90, 0xF0,                                   // 0
             0x20, 0x60, 0x20, 0x20, 0x70,                                   // 1
@@ -48,13 +70,23 @@ class Chip8 {
             0xF0, 0x80, 0xF0, 0x80, 0x80                                    // F
         };
 
+        // Instrumentation
+        MemoryProfile* profile = nullptr;                               // Records Reads, Writes and Executes of Memory When Set
+        uint64_t romHash = 0;                                           // 64-bit FNV-1a Hash of the Loaded ROM Image, Identifies the ROM to Saved Profiles
+
         // Random Number Generation
         std::default_random_engine randomGenerator;                     // Random Number Generator
         std::uniform_int_distribution<uint8_t> randomByte;              // Random Byte Generated by RNG
 
-        Chip8();                                                        // Initialize the CHIP-8
+        Chip8();                                                        // Initialize the CHIP-8, Seeding the RNG with the Current Time
+        Chip8(unsigned int seed);                                       // Initialize the CHIP-8 with a Fixed RNG Seed for Reproducible Runs
         void loadROM(const char* path);                             // Loads a ROM into memoery at the START_ADDRESS
         void cycle();                                                   // Fetch, Decode, and Execute Each Instruction
+        void pressKey(uint8_t key);                                     // Mark a Key as Held
+        void releaseKey(uint8_t key);                                   // Mark a Key as Released, Waking Fx0A if it is Waiting
+        uint64_t videoHash() const;                                     // 64-bit FNV-1a Hash of the Video Memory
+        void saveState(Chip8State& state) const;                        // Copy the Running State into a Snapshot
+        void loadState(const Chip8State& state);                        // Restore the Running State from a Snapshot
 
         // CPU Instructions
 
@@ -104,10 +136,10 @@ class Chip8 {
         // Function Tables
         typedef void (Chip8::*Chip8Function)();                         // Type for a CPU Instruction Function
         Chip8Function functionTable[0x0F + 1] { &Chip8::op_NULL };      // Primary Function Table for CPU Inustructions
-        Chip8Function functionTable0[0x0E + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With 0
-        Chip8Function functionTable8[0x0E + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With 8
-        Chip8Function functionTableE[0x0E + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With E
-        Chip8Function functionTableF[0x65 + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With F
+        Chip8Function functionTable0[0x0F + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With 0
+        Chip8Function functionTable8[0x0F + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With 8
+        Chip8Function functionTableE[0x0F + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With E
+        Chip8Function functionTableF[0xFF + 1] { &Chip8::op_NULL };     // Function Table for CPU Instructions That Start With F
 };
 
 #endif
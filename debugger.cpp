@@ -0,0 +1,395 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "chip8.hpp"
+#include "debugger.hpp"
+
+/*
+    Commands (addresses and values accept decimal or 0x-prefixed hex):
+        pause                   Stop execution
+        continue                Resume execution
+        step [n]                Execute n instructions (default 1) and report the registers; large counts run over several frames
+        break <address>         Stop before executing the instruction at address
+        delete <address>        Remove a breakpoint
+        watch <address>         Stop after an instruction changes the byte at address
+        unwatch <address>       Remove a watchpoint
+        regs                    Report the registers
+        set <register> <value>  Write v0-vf, i, pc, sp, dt or st
+        video                   Report the display as hex, one bit per pixel, rows top to bottom
+        key <key> <0|1>         Release or press a keypad key
+    Stops caused by breakpoints or watchpoints while running are reported as {"event": ...} lines
+*/
+
+const uint64_t STEPS_PER_FRAME = 100000;   // Most Instructions a Step Command Runs per Frame, so the Window Stays Responsive
+const size_t MAX_OUTPUT = 1 << 20;         // Most Unsent Reply Bytes Kept for a Client That is Not Reading Before it is Dropped
+
+#ifndef _WIN32
+// Remove a socket file, refusing to touch anything that is not a socket; returns true if the path is now free
+static bool removeSocket(const std::string& path) {
+    struct stat info;
+    if(lstat(path.c_str(), &info) < 0)
+        return errno == ENOENT;
+    if(!S_ISSOCK(info.st_mode))
+        return false;
+    return unlink(path.c_str()) == 0;
+}
+#endif
+
+// Build the JSON object describing the registers
+static std::string registersJson(const Chip8& chip8, bool paused) {
+    std::ostringstream json;
+    json << "{\"paused\":" << (paused ? "true" : "false")
+         << ",\"pc\":" << chip8.programCounter
+         << ",\"i\":" << chip8.index
+         << ",\"sp\":" << static_cast<int>(chip8.stackPointer)
+         << ",\"dt\":" << static_cast<int>(chip8.delayTimer)
+         << ",\"st\":" << static_cast<int>(chip8.soundTimer)
+         << ",\"v\":[";
+    for(int i = 0; i < 16; i++)
+        json << (i ? "," : "") << static_cast<int>(chip8.registers[i]);
+    json << "]}";
+    return json.str();
+}
+
+// Starts Listening on socketPath; nullptr Disables the Server
+Debugger::Debugger(const char* socketPath) {
+    if(socketPath == nullptr)
+        return;
+#ifdef _WIN32
+    std::cerr << "The debug server is not supported on this platform\n";
+#else
+    socketPath_ = socketPath;
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if(socketPath_.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Debug socket path is too long: " << socketPath_ << "\n";
+        return;
+    }
+    strcpy(address.sun_path, socketPath_.c_str());
+
+    // Remove a stale socket left behind by a previous run, but never a regular file given by mistake
+    if(!removeSocket(socketPath_)) {
+        std::cerr << "Not starting the debug server: " << socketPath_ << " exists and is not a socket\n";
+        return;
+    }
+
+    listenSocket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenSocket_ < 0
+        || bind(listenSocket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(listenSocket_, 1) < 0) {
+        std::cerr << "Could not start the debug server on " << socketPath_ << ": " << strerror(errno) << "\n";
+        if(listenSocket_ >= 0)
+            close(listenSocket_);
+        listenSocket_ = -1;
+        return;
+    }
+    // Never block the emulator waiting for a client
+    fcntl(listenSocket_, F_SETFL, fcntl(listenSocket_, F_GETFL) | O_NONBLOCK);
+#endif
+}
+// Closes all Sockets and Removes the Socket File
+Debugger::~Debugger() {
+#ifndef _WIN32
+    if(clientSocket_ >= 0)
+        close(clientSocket_);
+    if(listenSocket_ >= 0) {
+        close(listenSocket_);
+        removeSocket(socketPath_);
+    }
+#endif
+}
+
+// Is a Client Connected?
+bool Debugger::attached() const {
+    return clientSocket_ >= 0;
+}
+/*
+    Will the Next cycle() Run at Least One Instruction?
+    False while paused, or when running into a breakpoint, so input is only applied when an instruction can see it
+*/
+bool Debugger::willExecute(const Chip8& chip8) const {
+    if(!attached())
+        return true;
+    if(paused_ && stepsRemaining_ == 0)
+        return false;
+    return resuming_ || !breakpoints_.test(chip8.programCounter & 0x0FFFu);
+}
+// Accept Clients and Handle Pending Commands; Call Once per Frame
+void Debugger::poll(Chip8& chip8) {
+    if(listenSocket_ < 0)
+        return;
+#ifndef _WIN32
+    if(clientSocket_ < 0) {
+        accept();
+        if(clientSocket_ < 0)
+            return;
+    }
+
+    // Drain everything the client has sent so far
+    char buffer[512];
+    while(!closing_) {
+        ssize_t received = recv(clientSocket_, buffer, sizeof(buffer), 0);
+        if(received > 0) {
+            inputBuffer_.append(buffer, received);
+        } else if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else if(received == 0) {
+            // The client has finished sending, but may still be waiting for replies to what it sent
+            closing_ = true;
+            // A last command without a newline still counts
+            if(!inputBuffer_.empty() && inputBuffer_.back() != '\n')
+                inputBuffer_ += '\n';
+        } else {
+            // The connection is broken, so nothing more can be delivered
+            detach();
+            return;
+        }
+    }
+
+    // Handle every complete line
+    size_t end;
+    while((end = inputBuffer_.find('\n')) != std::string::npos) {
+        std::string line = inputBuffer_.substr(0, end);
+        inputBuffer_.erase(0, end + 1);
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if(!line.empty())
+            handleCommand(chip8, line);
+    }
+
+    // Let the emulator run freely again once a departing client has every reply, including the one for a running step
+    flush();
+    if(closing_ && outputBuffer_.empty() && stepsRemaining_ == 0)
+        detach();
+#endif
+}
+// Run One Cycle Under Debugger Control; Used Instead of Chip8::cycle() While Attached
+void Debugger::cycle(Chip8& chip8) {
+    if(stepsRemaining_ > 0)
+        runSteps(chip8);
+    else if(!paused_)
+        step(chip8);
+}
+
+// Accept a Waiting Client if There is None Attached
+void Debugger::accept() {
+#ifndef _WIN32
+    clientSocket_ = ::accept(listenSocket_, nullptr, nullptr);
+    if(clientSocket_ >= 0)
+        fcntl(clientSocket_, F_SETFL, fcntl(clientSocket_, F_GETFL) | O_NONBLOCK);
+#endif
+}
+// Close the Client and Reset All Debugging State
+void Debugger::detach() {
+#ifndef _WIN32
+    close(clientSocket_);
+#endif
+    clientSocket_ = -1;
+    inputBuffer_.clear();
+    outputBuffer_.clear();
+    closing_ = false;
+    paused_ = false;
+    resuming_ = false;
+    stepsRemaining_ = 0;
+    breakpoints_.reset();
+    watchpoints_.clear();
+}
+// Parse and Execute a Single Command
+void Debugger::handleCommand(Chip8& chip8, const std::string& line) {
+    std::istringstream arguments(line);
+    std::string command;
+    arguments >> command;
+
+    // Read the next argument as a number, accepting decimal or 0x-prefixed hex
+    auto number = [&arguments](unsigned long& value) {
+        std::string token;
+        if(!(arguments >> token))
+            return false;
+        char* end;
+        value = strtoul(token.c_str(), &end, 0);
+        return *end == '\0';
+    };
+    unsigned long address;
+    unsigned long value;
+
+    if(command == "pause") {
+        paused_ = true;
+        stepsRemaining_ = 0;
+        send(registersJson(chip8, paused_));
+    } else if(command == "continue") {
+        paused_ = false;
+        resuming_ = true;
+        stepsRemaining_ = 0;
+        send("{\"ok\":true}");
+    } else if(command == "step") {
+        unsigned long count = 1;
+        if(!number(count))
+            count = 1;
+        paused_ = true;
+        resuming_ = true;
+        stepsRemaining_ = count;
+        // Small counts finish right away; the rest carries on in cycle() on later frames
+        runSteps(chip8);
+    } else if(command == "break" && number(address) && address < breakpoints_.size()) {
+        breakpoints_.set(address);
+        send("{\"ok\":true}");
+    } else if(command == "delete" && number(address) && address < breakpoints_.size()) {
+        breakpoints_.reset(address);
+        send("{\"ok\":true}");
+    } else if(command == "watch" && number(address) && address < sizeof(chip8.memory)) {
+        watchpoints_.push_back({ static_cast<uint16_t>(address), chip8.memory[address] });
+        send("{\"ok\":true}");
+    } else if(command == "unwatch" && number(address)) {
+        for(size_t i = 0; i < watchpoints_.size(); i++) {
+            if(watchpoints_[i].address == address) {
+                watchpoints_.erase(watchpoints_.begin() + i);
+                break;
+            }
+        }
+        send("{\"ok\":true}");
+    } else if(command == "regs") {
+        send(registersJson(chip8, paused_));
+    } else if(command == "set") {
+        std::string name;
+        arguments >> name;
+        if(!number(value)) {
+            send("{\"error\":\"missing value\"}");
+        } else if(name.size() == 2 && (name[0] == 'v' || name[0] == 'V') && isxdigit(name[1])) {
+            chip8.registers[std::stoi(name.substr(1), nullptr, 16)] = value;
+            send(registersJson(chip8, paused_));
+        } else if(name == "i") {
+            chip8.index = value & 0x0FFFu;
+            send(registersJson(chip8, paused_));
+        } else if(name == "pc") {
+            chip8.programCounter = value & 0x0FFFu;
+            send(registersJson(chip8, paused_));
+        } else if(name == "sp") {
+            chip8.stackPointer = value & 0x0Fu;
+            send(registersJson(chip8, paused_));
+        } else if(name == "dt") {
+            chip8.delayTimer = value;
+            send(registersJson(chip8, paused_));
+        } else if(name == "st") {
+            chip8.soundTimer = value;
+            send(registersJson(chip8, paused_));
+        } else {
+            send("{\"error\":\"unknown register\"}");
+        }
+    } else if(command == "video") {
+        // Pack eight pixels per byte, most significant bit first
+        const char* digits = "0123456789abcdef";
+        std::string packed;
+        for(size_t i = 0; i < sizeof(chip8.video) / sizeof(chip8.video[0]); i += 8) {
+            uint8_t byte = 0;
+            for(size_t j = 0; j < 8; j++)
+                byte = (byte << 1) | (chip8.video[i + j] ? 1 : 0);
+            packed += digits[byte >> 4];
+            packed += digits[byte & 0x0F];
+        }
+        send("{\"width\":64,\"height\":32,\"video\":\"" + packed + "\"}");
+    } else if(command == "key" && number(address) && address < 16 && number(value)) {
+        if(value)
+            chip8.pressKey(address);
+        else
+            chip8.releaseKey(address);
+        send("{\"ok\":true}");
+    } else {
+        send("{\"error\":\"bad command\"}");
+    }
+}
+/*
+    Queue a Line for the Client and Send What the Socket Will Take
+    The client socket is non-blocking, so a reply that does not fit is kept and the rest goes out on later polls; lines are
+    never cut short. A client that leaves more than MAX_OUTPUT unread is treated as gone.
+*/
+void Debugger::send(const std::string& reply) {
+    if(clientSocket_ < 0)
+        return;
+    outputBuffer_ += reply;
+    outputBuffer_ += '\n';
+    flush();
+}
+// Send as Much Queued Output as the Socket Will Take Without Blocking
+void Debugger::flush() {
+#ifndef _WIN32
+    size_t sent = 0;
+    bool gone = false;
+    while(sent < outputBuffer_.size()) {
+#ifdef MSG_NOSIGNAL
+        ssize_t written = ::send(clientSocket_, outputBuffer_.data() + sent, outputBuffer_.size() - sent, MSG_NOSIGNAL);
+#else
+        ssize_t written = ::send(clientSocket_, outputBuffer_.data() + sent, outputBuffer_.size() - sent, 0);
+#endif
+        if(written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if(written <= 0) {
+            gone = true;
+            break;
+        }
+        sent += written;
+    }
+    outputBuffer_.erase(0, sent);
+
+    // Nothing more goes to a client that is gone or is not reading; it is detached on the next poll
+    if(gone || outputBuffer_.size() > MAX_OUTPUT) {
+        outputBuffer_.clear();
+        inputBuffer_.clear();
+        closing_ = true;
+        stepsRemaining_ = 0;
+    }
+#endif
+}
+// Run up to STEPS_PER_FRAME of the Pending Steps, Reporting the Registers Once They are Done
+void Debugger::runSteps(Chip8& chip8) {
+    uint64_t batch = std::min(stepsRemaining_, STEPS_PER_FRAME);
+    for(uint64_t i = 0; i < batch; i++) {
+        stepsRemaining_--;
+        if(!step(chip8)) {
+            // A breakpoint or watchpoint ends the step early
+            stepsRemaining_ = 0;
+            break;
+        }
+    }
+    if(stepsRemaining_ == 0)
+        send(registersJson(chip8, paused_));
+}
+// Execute One Instruction; Returns False if a Breakpoint or Watchpoint Stopped It
+bool Debugger::step(Chip8& chip8) {
+    // Stop before the instruction, unless we are resuming from this very breakpoint
+    if(!resuming_ && breakpoints_.test(chip8.programCounter & 0x0FFFu)) {
+        paused_ = true;
+        send("{\"event\":\"break\",\"pc\":" + std::to_string(chip8.programCounter) + "}");
+        return false;
+    }
+    resuming_ = false;
+
+    uint16_t instructionAddress = chip8.programCounter;
+    chip8.cycle();
+
+    // Stop after the instruction if it changed a watched byte
+    for(Watchpoint& watchpoint : watchpoints_) {
+        if(chip8.memory[watchpoint.address] != watchpoint.value) {
+            watchpoint.value = chip8.memory[watchpoint.address];
+            paused_ = true;
+            send("{\"event\":\"watch\",\"address\":" + std::to_string(watchpoint.address)
+                + ",\"value\":" + std::to_string(watchpoint.value)
+                + ",\"pc\":" + std::to_string(instructionAddress) + "}");
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef DEBUGGER_HPP
+#define DEBUGGER_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chip8.hpp"
+
+/*
+    Local debugger/control server listening on a Unix domain socket
+    Clients send newline-terminated text commands and receive one JSON object per line in reply
+    While no client is attached the emulator runs Chip8::cycle() directly, so the server costs one poll per frame
+*/
+class Debugger {
+    private:
+        struct Watchpoint {
+            uint16_t address;                                           // Watched Memory Address
+            uint8_t value;                                              // Value Last Seen at the Address
+        };
+
+        std::string socketPath_;                                        // Path of the Unix Domain Socket
+        int listenSocket_ = -1;                                         // Socket Accepting Clients, -1 if the Server is Disabled
+        int clientSocket_ = -1;                                         // Socket of the Attached Client, -1 if None
+        std::string inputBuffer_;                                       // Received Bytes That Do Not Yet Form a Complete Line
+        std::string outputBuffer_;                                      // Reply Bytes the Client's Socket Has Not Accepted Yet
+        bool closing_ = false;                                          // Has the Client Stopped Sending? Detach Once its Replies are Delivered
+        bool paused_ = false;                                           // Is Execution Stopped?
+        bool resuming_ = false;                                         // Skip the Breakpoint at the Current Address for the Next Instruction
+        uint64_t stepsRemaining_ = 0;                                   // Instructions Left to Run for the Current Step Command
+        std::bitset<4096> breakpoints_;                                 // One Bit per Memory Address Where Execution Stops
+        std::vector<Watchpoint> watchpoints_;                           // Memory Addresses That Stop Execution When Changed
+
+        void accept();                                                  // Accept a Waiting Client if There is None Attached
+        void detach();                                                  // Close the Client and Reset All Debugging State
+        void handleCommand(Chip8& chip8, const std::string& line);      // Parse and Execute a Single Command
+        void send(const std::string& reply);                            // Queue a Line for the Client and Send What the Socket Will Take
+        void flush();                                                   // Send as Much Queued Output as the Socket Will Take Without Blocking
+        void runSteps(Chip8& chip8);                                    // Run Up to STEPS_PER_FRAME of the Pending Steps, Reporting the Registers Once They are Done
+        bool step(Chip8& chip8);                                        // Execute One Instruction; Returns False if a Breakpoint or Watchpoint Stopped It
+    public:
+        Debugger(const char* socketPath);                               // Starts Listening on socketPath; nullptr Disables the Server
+        ~Debugger();                                                    // Closes all Sockets and Removes the Socket File
+
+        bool attached() const;                                          // Is a Client Connected?
+        bool willExecute(const Chip8& chip8) const;                     // Will the Next cycle() Run at Least One Instruction?
+        void poll(Chip8& chip8);                                        // Accept Clients and Handle Pending Commands; Call Once per Frame
+        void cycle(Chip8& chip8);                                       // Run One Cycle Under Debugger Control; Used Instead of Chip8::cycle() While Attached
+};
+
+#endif
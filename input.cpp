@@ -0,0 +1,56 @@
+#include <cstdint>
+#include "chip8.hpp"
+#include "input.hpp"
+
+// Queue an Event; the Queue Grows Rather Than Drop One, Since a Lost Release Would Leave a Key Held Forever
+void InputQueue::push(const InputEvent& event) {
+    events_.push_back(event);
+}
+/*
+    Apply Events Due by now, Right Before the Next Instruction
+    Events stay in order: once a release has to wait for the next boundary, everything after it waits too
+*/
+void InputQueue::apply(Chip8& chip8, uint32_t now) {
+    // Keys pressed during this batch
+    uint16_t pressed = 0;
+
+    while(!events_.empty()) {
+        const InputEvent& event = events_.front();
+        // Not due yet
+        if(event.timestamp > now)
+            break;
+        uint16_t bit = 1u << event.key;
+        // Latch the press: hold the release back until an instruction has run
+        if(!event.pressed && (pressed & bit))
+            break;
+
+        if(event.pressed) {
+            chip8.pressKey(event.key);
+            pressed |= bit;
+        } else {
+            chip8.releaseKey(event.key);
+        }
+
+        // The next instruction is the first to see this event
+        uint32_t latency = now - event.timestamp;
+        totalLatency_ += latency;
+        if(latency > maxLatency_)
+            maxLatency_ = latency;
+        appliedCount_++;
+
+        events_.pop_front();
+    }
+}
+
+// Number of Events Applied so Far
+uint64_t InputQueue::appliedCount() const {
+    return appliedCount_;
+}
+// Average Event-to-Instruction Latency in Milliseconds
+double InputQueue::averageLatency() const {
+    return appliedCount_ ? static_cast<double>(totalLatency_) / appliedCount_ : 0.0;
+}
+// Largest Event-to-Instruction Latency in Milliseconds
+uint32_t InputQueue::maxLatency() const {
+    return maxLatency_;
+}
@@ -0,0 +1,36 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <cstdint>
+#include <deque>
+#include "chip8.hpp"
+
+// A single key transition, stamped with the time it was generated
+struct InputEvent {
+    uint32_t timestamp;                                                 // Time of the Event in Milliseconds
+    uint8_t key;                                                        // CHIP-8 Key (0x0 to 0xF)
+    bool pressed;                                                       // Was the Key Pressed (true) or Released (false)?
+};
+
+/*
+    Queue of timestamped key events waiting to be applied to the CHIP-8
+    Events are applied at instruction boundaries. A key pressed and released in the same batch only has its press applied;
+    the release waits for the next boundary so at least one instruction sees the key held.
+*/
+class InputQueue {
+    private:
+        std::deque<InputEvent> events_;                                 // Pending Events, Oldest First; Grows Rather Than Drop a Release
+
+        uint64_t appliedCount_ = 0;                                     // Number of Events Applied so Far
+        uint64_t totalLatency_ = 0;                                     // Sum of Event-to-Instruction Latencies in Milliseconds
+        uint32_t maxLatency_ = 0;                                       // Largest Event-to-Instruction Latency in Milliseconds
+    public:
+        void push(const InputEvent& event);                             // Queue an Event
+        void apply(Chip8& chip8, uint32_t now);                         // Apply Events Due by now, Right Before the Next Instruction
+
+        uint64_t appliedCount() const;                                  // Number of Events Applied so Far
+        double averageLatency() const;                                  // Average Event-to-Instruction Latency in Milliseconds
+        uint32_t maxLatency() const;                                    // Largest Event-to-Instruction Latency in Milliseconds
+};
+
+#endif
@@ -1,14 +1,26 @@
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include "chip8.hpp"
+#include "debugger.hpp"
+#include "input.hpp"
+#include "profile.hpp"
 #include "renderer.hpp"
+#include "runahead.hpp"
+#include "upscaler.hpp"
 
 const int VIDEO_WIDTH = 64;     // Width of Video Display
 const int VIDEO_HEIGHT = 32;    // Height of Video Display
 
 int main(int argc, char** argv) {
-    if(argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <Display Scale Factor> <Cycle Speed in ms> <Path to ROM>\n";
+    if(argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <Display Scale Factor> <Cycle Speed in ms> <Path to ROM> [Options]\n"
+                  << "Options:\n"
+                  << "  --filter <nearest|scanline|scale2x>    Upscaling filter (default: nearest); scale2x needs an even scale\n"
+                  << "  --debug-socket <path>                  Listen for a debugger on a Unix domain socket\n"
+                  << "  --keymap <16 keys>                     Host keys for CHIP-8 keys 0x0 to 0xF (default: x123qweasdzc4rfv)\n"
+                  << "  --profile <path>                       Record memory accesses, merging into and saving the profile at path\n"
+                  << "  --run-ahead <frames>                   Present the frame this many frames ahead of the real one to hide input lag\n";
         return 1;
     }
 
@@ -17,22 +29,85 @@ int main(int argc, char** argv) {
     int cycleSpeed = std::stoi(argv[2]);
     const char* romPath = argv[3];
 
+    // Parse options
+    UpscaleFilter filter = UpscaleFilter::Nearest;
+    const char* debugSocketPath = nullptr;
+    const char* keymap = nullptr;
+    const char* profilePath = nullptr;
+    int runAheadFrames = 0;
+    for(int i = 4; i < argc; i++) {
+        if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            if(!Upscaler::parseFilter(argv[++i], filter)) {
+                std::cerr << "Unknown filter: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if(strcmp(argv[i], "--debug-socket") == 0 && i + 1 < argc) {
+            debugSocketPath = argv[++i];
+        } else if(strcmp(argv[i], "--keymap") == 0 && i + 1 < argc) {
+            keymap = argv[++i];
+        } else if(strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if(strcmp(argv[i], "--run-ahead") == 0 && i + 1 < argc) {
+            runAheadFrames = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    // Scale2x doubles the frame before replicating it, so an odd scale would silently fall back to nearest
+    if(filter == UpscaleFilter::Scale2x && displayScale % 2 != 0) {
+        std::cerr << "The scale2x filter needs an even display scale factor\n";
+        return 1;
+    }
+
     // Create the window using the rendering
-    Renderer renderer("Chip 'n Dale - CHIP-8 Emulator", VIDEO_WIDTH * displayScale, VIDEO_HEIGHT * displayScale, VIDEO_WIDTH, VIDEO_HEIGHT);
+    Renderer renderer("Chip 'n Dale - CHIP-8 Emulator", VIDEO_WIDTH * displayScale, VIDEO_HEIGHT * displayScale, VIDEO_WIDTH, VIDEO_HEIGHT, filter);
+    if(keymap && !renderer.mapKeys(keymap)) {
+        std::cerr << "A keymap needs exactly 16 keys\n";
+        return 1;
+    }
 
     // Create the CHIP-8 and load the rOM into memory.
     Chip8 chip8;
     chip8.loadROM(romPath);
 
+    // Record memory accesses if requested, adding to what earlier runs of the same ROM saw
+    MemoryProfile profile;
+    if(profilePath) {
+        profile.romHash = chip8.romHash;
+        switch(profile.load(profilePath)) {
+            case ProfileLoad::Loaded:
+            case ProfileLoad::Missing:
+                break;
+            case ProfileLoad::OtherRom:
+                std::cerr << "The memory profile at " << profilePath << " was recorded from a different ROM or an older version; it will be replaced\n";
+                break;
+            case ProfileLoad::Invalid:
+                // Not overwritten, since the path may name some other file entirely
+                std::cerr << "Could not read the memory profile at " << profilePath << "\n";
+                return 1;
+        }
+        chip8.profile = &profile;
+    }
+
+    // Start the debug server if requested; without a client attached it only polls once per frame
+    Debugger debugger(debugSocketPath);
+
+    // Speculative instance on a worker thread; does nothing unless run-ahead is on
+    RunAhead runAhead(runAheadFrames);
+
     // Number of bytes in a row of pixel data; used for SDL Window updating
     int videoPitch = sizeof(chip8.video[0]) * VIDEO_WIDTH;
     // Start time used for cycle calculations
     auto lastCycleTime = std::chrono::high_resolution_clock::now();
+    // Key events waiting for the next instruction boundary
+    InputQueue input;
     // Should the program end or not?
     bool quit = false;
     while(!quit) {
         // Check to quite by checking if the "ESC" key has been pressed
-        quit = renderer.processInput(chip8.keypad);
+        quit = renderer.processInput(input);
         
         // Get the current time
         auto currentTime = std::chrono::high_resolution_clock::now();
@@ -42,13 +117,42 @@ int main(int argc, char** argv) {
         if(deltaTime > cycleSpeed) {
             // Reset variable
             lastCycleTime = currentTime;
-            // Execute a cycle
-            chip8.cycle();
-            // Update the window with the new information
-            renderer.update(chip8.video, videoPitch);
+            // Handle debugger commands first, since they decide whether an instruction runs this tick
+            debugger.poll(chip8);
+            // Apply the key events that happened before this instruction; while the debugger holds execution they stay queued
+            if(debugger.willExecute(chip8))
+                input.apply(chip8, renderer.ticks());
+            // Execute a cycle, under debugger control only if a client is attached
+            if(debugger.attached())
+                debugger.cycle(chip8);
+            else
+                chip8.cycle();
+            // Update the window with the new information, from a few frames ahead if run-ahead is on and no debugger is attached
+            if(runAhead.enabled() && !debugger.attached())
+                renderer.update(runAhead.run(chip8), videoPitch);
+            else
+                renderer.update(chip8.video, videoPitch);
         }
     }
 
+    // Report how long key events waited before an instruction could see them
+    if(input.appliedCount() > 0)
+        std::cout << "Input latency over " << input.appliedCount() << " events: "
+                  << input.averageLatency() << " ms average, " << input.maxLatency() << " ms max\n";
+
+    // Report what run-ahead added to each frame
+    if(runAhead.frameCount() > 0)
+        std::cout << "Run-ahead cost over " << runAhead.frameCount() << " frames: "
+                  << runAhead.averageCost() << " us average, " << runAhead.maxCost() << " us max, "
+                  << runAhead.waitCount() << " frames waited for the worker\n";
+
+    // Report and save the memory profile
+    if(profilePath) {
+        profile.report(std::cout);
+        if(!profile.save(profilePath))
+            std::cerr << "Could not save the memory profile to " << profilePath << "\n";
+    }
+
     // Proper exit
     return 0;
 }
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "profile.hpp"
+
+/*
+    Profile file format (text):
+        chipndale-profile 2
+        rom <hash>              64-bit hash of the ROM image the profile was recorded from, in hex
+        smc <0|1>
+        <start> <end> <flags>   One line per run of addresses sharing the same non-zero flags, all in hex, end inclusive
+*/
+
+const int MEMORY_SIZE = 4096;           // Number of Profiled Addresses
+const int HOT_TABLE_COUNT = 8;          // Number of Data Tables Listed in the Report
+const int PROFILE_VERSION = 2;          // Version Written on the First Line of Profile Files
+
+// A run of consecutive addresses
+struct Region {
+    uint16_t start;                     // First Address of the Run
+    uint16_t end;                       // Last Address of the Run
+    uint64_t reads;                     // Total Data Reads Across the Run
+};
+
+// Find every run of consecutive addresses whose flags satisfy the predicate
+template<typename Predicate>
+static std::vector<Region> findRegions(const MemoryProfile& profile, Predicate matches) {
+    std::vector<Region> regions;
+    for(int address = 0; address < MEMORY_SIZE; address++) {
+        if(!matches(profile.flags[address]))
+            continue;
+        if(regions.empty() || regions.back().end != address - 1)
+            regions.push_back({ static_cast<uint16_t>(address), static_cast<uint16_t>(address), 0 });
+        regions.back().end = address;
+        regions.back().reads += profile.reads[address];
+    }
+    return regions;
+}
+// Format an address as 0x followed by three hex digits
+static std::string hexAddress(uint16_t address) {
+    char buffer[8];
+    snprintf(buffer, sizeof(buffer), "0x%03X", address);
+    return buffer;
+}
+
+// Record a Data Read
+void MemoryProfile::markRead(uint16_t address) {
+    address &= 0x0FFFu;
+    flags[address] |= READ;
+    reads[address]++;
+}
+// Record a Write
+void MemoryProfile::markWrite(uint16_t address) {
+    flags[address & 0x0FFFu] |= WRITE;
+}
+// Record an Instruction Fetch
+void MemoryProfile::markExecute(uint16_t address) {
+    flags[address & 0x0FFFu] |= EXECUTE;
+}
+
+// Was Any Address Both Written and Executed?
+bool MemoryProfile::selfModifying() const {
+    for(int address = 0; address < MEMORY_SIZE; address++) {
+        if((flags[address] & (WRITE | EXECUTE)) == (WRITE | EXECUTE))
+            return true;
+    }
+    return false;
+}
+// Print Self-Modifying Regions and the Hottest Data Tables
+void MemoryProfile::report(std::ostream& out) const {
+    std::vector<Region> modified = findRegions(*this, [](uint8_t f) { return (f & (WRITE | EXECUTE)) == (WRITE | EXECUTE); });
+    // Data tables are read but never executed
+    std::vector<Region> tables = findRegions(*this, [](uint8_t f) { return (f & READ) && !(f & EXECUTE); });
+    std::sort(tables.begin(), tables.end(), [](const Region& a, const Region& b) { return a.reads > b.reads; });
+
+    out << "Memory profile:\n";
+    out << "  Self-modifying code: " << (modified.empty() ? "no" : "yes") << "\n";
+    for(const Region& region : modified)
+        out << "  SMC region " << hexAddress(region.start) << "-" << hexAddress(region.end) << "\n";
+    for(size_t i = 0; i < tables.size() && i < HOT_TABLE_COUNT; i++) {
+        out << "  Data table " << hexAddress(tables[i].start) << "-" << hexAddress(tables[i].end)
+            << " (" << tables[i].reads << " reads)\n";
+    }
+}
+// Write the ROM Hash and Flags to a Profile File
+bool MemoryProfile::save(const char* path) const {
+    std::ofstream file(path);
+    if(!file.is_open())
+        return false;
+
+    file << "chipndale-profile " << PROFILE_VERSION << "\n";
+    file << std::hex;
+    file << "rom " << romHash << "\n";
+    file << "smc " << (selfModifying() ? 1 : 0) << "\n";
+    int address = 0;
+    while(address < MEMORY_SIZE) {
+        // Extend the run while the flags stay the same
+        int end = address;
+        while(end + 1 < MEMORY_SIZE && flags[end + 1] == flags[address])
+            end++;
+        if(flags[address])
+            file << address << " " << end << " " << static_cast<int>(flags[address]) << "\n";
+        address = end + 1;
+    }
+    return file.good();
+}
+/*
+    Merge the Flags from a Profile File of the Same ROM into This Profile
+    The whole file is parsed before anything is merged, so a file that turns out to be malformed leaves the profile untouched
+*/
+ProfileLoad MemoryProfile::load(const char* path) {
+    std::ifstream file(path);
+    if(!file.is_open())
+        return ProfileLoad::Missing;
+
+    std::string magic;
+    int version;
+    if(!(file >> magic >> version) || magic != "chipndale-profile")
+        return ProfileLoad::Invalid;
+    // Version 1 files carry no ROM hash, so there is no telling which ROM they describe
+    if(version != PROFILE_VERSION)
+        return version == 1 ? ProfileLoad::OtherRom : ProfileLoad::Invalid;
+
+    std::string key;
+    uint64_t fileRomHash;
+    if(!(file >> key >> std::hex >> fileRomHash) || key != "rom")
+        return ProfileLoad::Invalid;
+    if(fileRomHash != romHash)
+        return ProfileLoad::OtherRom;
+
+    // The smc line is derived from the flags, so it only matters to readers that skip the runs
+    int selfModifyingCode;
+    if(!(file >> key >> selfModifyingCode) || key != "smc")
+        return ProfileLoad::Invalid;
+
+    std::vector<uint8_t> loaded(MEMORY_SIZE, 0);
+    unsigned int start, end, runFlags;
+    while(file >> start >> end >> runFlags) {
+        for(unsigned int address = start; address <= end && address < MEMORY_SIZE; address++)
+            loaded[address] |= runFlags;
+    }
+    if(!file.eof())
+        return ProfileLoad::Invalid;
+
+    for(int address = 0; address < MEMORY_SIZE; address++)
+        flags[address] |= loaded[address];
+    return ProfileLoad::Loaded;
+}
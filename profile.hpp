@@ -0,0 +1,41 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <cstdint>
+#include <ostream>
+
+// Outcome of Loading a Profile File
+enum class ProfileLoad {
+    Loaded,                                                             // The File Was Recorded from the Same ROM and its Flags Were Merged
+    Missing,                                                            // There is No File Yet
+    OtherRom,                                                           // The File Belongs to a Different ROM, or Predates ROM Identities; Nothing Was Merged
+    Invalid                                                             // The File is Not a Readable Profile; Nothing Was Merged
+};
+
+/*
+    Per-address record of how a ROM uses the 4 KB of CHIP-8 memory
+    Addresses that are both written and executed mark self-modifying code; addresses that are only read are data tables.
+    Profiles are saved per ROM so other execution engines can check for self-modifying code before picking a fast path.
+    Each file records the hash of the ROM image it came from, and is only merged into a profile of the same ROM.
+*/
+class MemoryProfile {
+    public:
+        static const uint8_t READ = 0x01;                               // Address Was Read as Data
+        static const uint8_t WRITE = 0x02;                              // Address Was Written
+        static const uint8_t EXECUTE = 0x04;                            // Address Was Fetched as Part of an Instruction
+
+        uint8_t flags[4096] {};                                         // Access Flags for Each Address
+        uint32_t reads[4096] {};                                        // Number of Data Reads of Each Address in This Run
+        uint64_t romHash = 0;                                           // Hash of the ROM Image Being Profiled, see Chip8::romHash
+
+        void markRead(uint16_t address);                                // Record a Data Read
+        void markWrite(uint16_t address);                               // Record a Write
+        void markExecute(uint16_t address);                             // Record an Instruction Fetch
+
+        bool selfModifying() const;                                     // Was Any Address Both Written and Executed?
+        void report(std::ostream& out) const;                           // Print Self-Modifying Regions and the Hottest Data Tables
+        bool save(const char* path) const;                              // Write the ROM Hash and Flags to a Profile File
+        ProfileLoad load(const char* path);                             // Merge the Flags from a Profile File of the Same ROM into This Profile
+};
+
+#endif
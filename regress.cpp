@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "chip8.hpp"
+#include "upscaler.hpp"
+
+/*
+    Headless golden-frame regression runner
+    Runs every ROM in a manifest for a fixed number of cycles with a fixed RNG seed, hashing the video memory at checkpoints
+    and comparing against stored golden hashes. ROMs run in parallel, one per thread.
+
+    Manifest format, one ROM per line (blank lines and lines starting with # are ignored, ROM paths are relative to the manifest):
+        <Path to ROM> [<Cycle>+<Key> | <Cycle>-<Key> ...] <Cycle>:<Golden Hash> [<Cycle>:<Golden Hash> ...]
+    <Cycle>+<Key> presses and <Cycle>-<Key> releases a hex key (0 to F) right before that cycle runs, so ROMs that read the
+    keypad can be scripted. With --record the golden hashes are ignored (write "-" for new checkpoints) and an updated
+    manifest is printed instead.
+
+    Every run also upscales two fixed frames with each filter, a range of scales and every kernel set the CPU supports,
+    and fails unless the SSE2 and AVX2 output matches the scalar output exactly.
+*/
+
+const unsigned int DEFAULT_SEED = 0xC8u;   // RNG Seed Used Unless --seed is Given
+const int UPSCALE_SCALES[] = { 1, 2, 3, 4, 5, 6, 7, 8, 10, 12 };   // Scales Checked; Those Not a Multiple of 8 Leave Tails for the Scalar Loops
+
+// A Point During a Run at Which the Video Memory is Hashed
+struct Checkpoint {
+    uint64_t cycle;                         // Number of Cycles Executed Before Hashing
+    std::string golden;                     // Expected Hash as 16 Hex Digits, "-" if Unknown
+    std::string actual;                     // Hash Produced by This Run
+};
+// A Scripted Key Press or Release
+struct KeyEvent {
+    uint64_t cycle;                         // Number of Cycles Executed Before the Event
+    uint8_t key;                            // CHIP-8 Key (0x0 to 0xF)
+    bool pressed;                           // Was the Key Pressed (true) or Released (false)?
+};
+// A ROM, its Scripted Input and its Checkpoints
+struct Entry {
+    std::string romPath;                    // Path to the ROM as Written in the Manifest
+    std::string resolvedPath;               // Path to the ROM Relative to the Working Directory
+    std::vector<KeyEvent> keys;             // Key Events in Ascending Cycle Order
+    std::vector<Checkpoint> checkpoints;    // Checkpoints in Ascending Cycle Order
+    bool loaded = false;                    // Could the ROM be Opened?
+};
+
+// Format a hash as 16 lowercase hex digits
+static std::string hashString(uint64_t hash) {
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+// Parse a whole string as an unsigned number (decimal, or hex with 0x); returns false if anything is left over
+static bool parseNumber(const std::string& text, unsigned long long& value) {
+    if(text.empty() || text[0] == '-')
+        return false;
+    char* end;
+    errno = 0;
+    value = strtoull(text.c_str(), &end, 0);
+    return *end == '\0' && errno == 0;
+}
+// Parse the manifest; returns false and reports the line on a syntax error
+static bool readManifest(const char* path, std::vector<Entry>& entries) {
+    std::ifstream file(path);
+    if(!file.is_open()) {
+        std::cerr << "Could not open manifest: " << path << "\n";
+        return false;
+    }
+    // ROM paths are relative to the directory holding the manifest
+    std::string directory = path;
+    size_t slash = directory.find_last_of("/\\");
+    directory = slash == std::string::npos ? "" : directory.substr(0, slash + 1);
+
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(file, line)) {
+        lineNumber++;
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+        std::istringstream fields(line);
+        Entry entry;
+        if(!(fields >> entry.romPath) || entry.romPath[0] == '#')
+            continue;
+        entry.resolvedPath = directory + entry.romPath;
+
+        std::string field;
+        while(fields >> field) {
+            size_t separator = field.find_first_of(":+-");
+            unsigned long long cycle;
+            unsigned long long key;
+            if(separator == std::string::npos || !parseNumber(field.substr(0, separator), cycle)) {
+                std::cerr << path << ":" << lineNumber << ": expected <cycle>:<hash> or <cycle>+<key>/<cycle>-<key>, got " << field << "\n";
+                return false;
+            }
+            if(field[separator] == ':') {
+                entry.checkpoints.push_back({ cycle, field.substr(separator + 1), "" });
+            } else if(parseNumber("0x" + field.substr(separator + 1), key) && field.size() == separator + 2) {
+                entry.keys.push_back({ cycle, static_cast<uint8_t>(key), field[separator] == '+' });
+            } else {
+                std::cerr << path << ":" << lineNumber << ": expected a hex key (0 to F), got " << field << "\n";
+                return false;
+            }
+        }
+        std::sort(entry.checkpoints.begin(), entry.checkpoints.end(),
+            [](const Checkpoint& a, const Checkpoint& b) { return a.cycle < b.cycle; });
+        // Stable, so events scripted for the same cycle keep their order
+        std::stable_sort(entry.keys.begin(), entry.keys.end(),
+            [](const KeyEvent& a, const KeyEvent& b) { return a.cycle < b.cycle; });
+        entries.push_back(entry);
+    }
+    return true;
+}
+// Run a single ROM, filling in the actual hash of every checkpoint
+static void run(Entry& entry, unsigned int seed) {
+    if(!std::ifstream(entry.resolvedPath, std::ios::binary).is_open())
+        return;
+    entry.loaded = true;
+
+    Chip8 chip8(seed);
+    chip8.loadROM(entry.resolvedPath.c_str());
+
+    uint64_t cycle = 0;
+    size_t nextKey = 0;
+    for(Checkpoint& checkpoint : entry.checkpoints) {
+        for(; cycle < checkpoint.cycle; cycle++) {
+            // Apply the key events scripted for this cycle before it runs
+            for(; nextKey < entry.keys.size() && entry.keys[nextKey].cycle <= cycle; nextKey++) {
+                if(entry.keys[nextKey].pressed)
+                    chip8.pressKey(entry.keys[nextKey].key);
+                else
+                    chip8.releaseKey(entry.keys[nextKey].key);
+            }
+            chip8.cycle();
+        }
+        checkpoint.actual = hashString(chip8.videoHash());
+    }
+}
+
+// Upscale two fixed frames with every filter and scale, comparing each vector kernel set with the scalar kernels
+static bool checkUpscaler() {
+    const int width = 64;
+    const int height = 32;
+    const UpscaleFilter filters[] = { UpscaleFilter::Nearest, UpscaleFilter::Scanline, UpscaleFilter::Scale2x };
+    const char* filterNames[] = { "nearest", "scanline", "scale2x" };
+    const UpscaleKernels kernels[] = { UpscaleKernels::Sse2, UpscaleKernels::Avx2 };
+    const char* kernelNames[] = { "sse2", "avx2" };
+
+    // A two-colour frame like the CHIP-8 draws, so Scale2x finds edges, and one with arbitrary colours and alpha
+    std::vector<uint32_t> frames[2] = { std::vector<uint32_t>(width * height), std::vector<uint32_t>(width * height) };
+    uint32_t random = 0x2545F491u;
+    auto next = [&random]() {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    };
+    for(int i = 0; i < width * height; i++) {
+        frames[0][i] = (next() & 0x100u) ? 0xFFFFFFFFu : 0x000000FFu;
+        frames[1][i] = next();
+    }
+
+    bool passed = true;
+    for(const std::vector<uint32_t>& frame : frames) {
+        for(size_t f = 0; f < std::size(filters); f++) {
+            for(int scale : UPSCALE_SCALES) {
+                Upscaler reference(width, height, scale, filters[f], UpscaleKernels::Scalar);
+                int outputPitch = reference.outputWidth() * sizeof(uint32_t);
+                std::vector<uint32_t> expected(reference.outputWidth() * reference.outputHeight());
+                reference.upscale(frame.data(), width * sizeof(uint32_t), expected.data(), outputPitch);
+
+                for(size_t k = 0; k < std::size(kernels); k++) {
+                    if(!Upscaler::supported(kernels[k]))
+                        continue;
+                    Upscaler upscaler(width, height, scale, filters[f], kernels[k]);
+                    std::vector<uint32_t> actual(expected.size());
+                    upscaler.upscale(frame.data(), width * sizeof(uint32_t), actual.data(), outputPitch);
+                    if(actual != expected) {
+                        std::cout << "FAIL upscaler: " << kernelNames[k] << " differs from scalar with "
+                                  << filterNames[f] << " at scale " << scale << "\n";
+                        passed = false;
+                    }
+                }
+            }
+        }
+    }
+
+    if(passed) {
+        std::cout << "PASS upscaler kernels: scalar";
+        for(size_t k = 0; k < std::size(kernels); k++) {
+            if(Upscaler::supported(kernels[k]))
+                std::cout << ", " << kernelNames[k];
+        }
+        std::cout << "\n";
+    }
+    return passed;
+}
+
+int main(int argc, char** argv) {
+    const char* manifestPath = nullptr;
+    bool record = false;
+    unsigned int seed = DEFAULT_SEED;
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    bool usageError = false;
+    for(int i = 1; i < argc && !usageError; i++) {
+        unsigned long long value;
+        if(strcmp(argv[i], "--record") == 0) {
+            record = true;
+        } else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            usageError = !parseNumber(argv[++i], value) || value > UINT_MAX;
+            seed = value;
+        } else if(strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            usageError = !parseNumber(argv[++i], value) || value == 0 || value > 1024;
+            threadCount = value;
+        } else if(!manifestPath) {
+            manifestPath = argv[i];
+        } else {
+            // More than one manifest
+            usageError = true;
+        }
+    }
+    if(!manifestPath || usageError) {
+        std::cerr << "Usage: " << argv[0] << " <Path to Manifest> [--record] [--seed <n>] [--jobs <n>]\n";
+        return 1;
+    }
+
+    std::vector<Entry> entries;
+    if(!readManifest(manifestPath, entries))
+        return 1;
+
+    // Hand out ROMs to worker threads until none are left
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> workers;
+    for(unsigned int t = 0; t < std::min<size_t>(threadCount, entries.size()); t++) {
+        workers.emplace_back([&]() {
+            for(size_t i = next++; i < entries.size(); i = next++)
+                run(entries[i], seed);
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+
+    // Report in manifest order so output is stable regardless of scheduling
+    int failures = 0;
+    for(const Entry& entry : entries) {
+        if(record) {
+            std::cout << entry.romPath;
+            for(const KeyEvent& event : entry.keys)
+                std::cout << " " << event.cycle << (event.pressed ? "+" : "-") << "0123456789ABCDEF"[event.key];
+            for(const Checkpoint& checkpoint : entry.checkpoints)
+                std::cout << " " << checkpoint.cycle << ":" << (entry.loaded ? checkpoint.actual : checkpoint.golden);
+            std::cout << "\n";
+            if(!entry.loaded)
+                std::cerr << "Could not open ROM: " << entry.resolvedPath << "\n";
+            continue;
+        }
+
+        if(!entry.loaded) {
+            std::cout << "FAIL " << entry.romPath << ": could not open ROM\n";
+            failures++;
+            continue;
+        }
+        bool passed = true;
+        for(const Checkpoint& checkpoint : entry.checkpoints) {
+            if(checkpoint.actual != checkpoint.golden) {
+                std::cout << "FAIL " << entry.romPath << " at cycle " << checkpoint.cycle
+                          << ": expected " << checkpoint.golden << ", got " << checkpoint.actual << "\n";
+                passed = false;
+            }
+        }
+        if(passed)
+            std::cout << "PASS " << entry.romPath << "\n";
+        else
+            failures++;
+    }
+
+    if(record)
+        return 0;
+    bool upscalerPassed = checkUpscaler();
+    std::cout << entries.size() - failures << "/" << entries.size() << " ROMs passed\n";
+    return failures || !upscalerPassed ? 1 : 0;
+}
@@ -1,14 +1,22 @@
+#include <cctype>
 #include <cstdint>
+#include <cstring>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_render.h>
+#include "input.hpp"
 #include "renderer.hpp"
+#include "upscaler.hpp"
 
-// Creates Display Window
-Renderer::Renderer(const char* title, int windowWidth, int windowHeight, int textureWidth, int textureHeight) {
+/*
+    Creates Display Window
+    The texture is created at the upscaled size so SDL_RenderCopy never has to stretch it; scaling happens on the CPU
+*/
+Renderer::Renderer(const char* title, int windowWidth, int windowHeight, int textureWidth, int textureHeight, UpscaleFilter filter)
+    : upscaler_(textureWidth, textureHeight, windowWidth / textureWidth, filter) {
     SDL_Init(SDL_INIT_VIDEO);
     window_ = SDL_CreateWindow(title, 0, 0, windowWidth, windowHeight, SDL_WINDOW_SHOWN);
     renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
-    texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, textureWidth, textureHeight);
+    texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, upscaler_.outputWidth(), upscaler_.outputHeight());
 }
 // Destroy each field object and stops displaying graphics
 Renderer::~Renderer() {
@@ -18,15 +26,31 @@ Renderer::~Renderer() {
     SDL_Quit();
 }
 
-// Update the Display with New Information
+// Update the Display with New Information; the frame is upscaled straight into the locked texture
 void Renderer::update(const void* buffer, int pitch) {
-    SDL_UpdateTexture(texture_, nullptr, buffer, pitch);
+    void* pixels;
+    int texturePitch;
+    if(SDL_LockTexture(texture_, nullptr, &pixels, &texturePitch) == 0) {
+        upscaler_.upscale(static_cast<const uint32_t*>(buffer), pitch, static_cast<uint32_t*>(pixels), texturePitch);
+        SDL_UnlockTexture(texture_);
+    }
     SDL_RenderClear(renderer_);
     SDL_RenderCopy(renderer_, texture_, nullptr, nullptr);
     SDL_RenderPresent(renderer_);
 }
-// Decide Action for each Key
-bool Renderer::processInput(uint8_t* keys) {
+/*
+    Rebind Keys from 16 Characters, One per CHIP-8 Key in Order 0x0 to 0xF
+    SDL keycodes for printable keys are their lowercase characters, e.g. the default layout is "x123qweasdzc4rfv"
+*/
+bool Renderer::mapKeys(const char* layout) {
+    if(strlen(layout) != 16)
+        return false;
+    for(int i = 0; i < 16; i++)
+        keymap_[i] = static_cast<SDL_Keycode>(tolower(static_cast<unsigned char>(layout[i])));
+    return true;
+}
+// Queue Key Events; Returns True When the Emulator Should Quit
+bool Renderer::processInput(InputQueue& input) {
     bool quit = false;
 
     SDL_Event event;
@@ -35,115 +59,21 @@ bool Renderer::processInput(uint8_t* keys) {
             case SDL_QUIT:
                 quit = true;
                 break;
-            case SDL_KEYDOWN: {
-                switch(event.key.keysym.sym) {
-                    case SDLK_ESCAPE:
-                        quit = true;
-                        break;
-                    case SDLK_x:
-                        keys[0x00] = 1;
-                        break;
-                    case SDLK_1:
-                        keys[0x01] = 1;
-						break;
-                    case SDLK_2:
-                        keys[0x02] = 1;
-						break;
-                    case SDLK_3:
-                        keys[0x03] = 1;
-                        break;
-                    case SDLK_q:
-                        keys[0x04] = 1;
-                        break;
-                    case SDLK_w:
-                        keys[0x05] = 1;
-                        break;
-                    case SDLK_e:
-                        keys[0x06] = 1;
-                        break;
-                    case SDLK_a:
-                        keys[0x07] = 1;
-                        break;
-                    case SDLK_s:
-                        keys[0x08] = 1;
-                        break;
-                    case SDLK_d:
-                        keys[0x09] = 1;
-                        break;
-                    case SDLK_z:
-                        keys[0x0A] = 1;
-                        break;
-                    case SDLK_c:
-                        keys[0x0B] = 1;
-                        break;
-                    case SDLK_4:
-                        keys[0x0C] = 1;
-                        break;
-                    case SDLK_r:
-                        keys[0x0D] = 1;
-                        break;
-                    case SDLK_f:
-                        keys[0x0E] = 1;
-                        break;
-                    case SDLK_v:
-                        keys[0x0F] = 1;
-                        break;
-                }
-                break;
-            }
+            case SDL_KEYDOWN:
             case SDL_KEYUP: {
-                switch(event.key.keysym.sym) {
-                    case SDLK_ESCAPE:
-                        quit = true;
-                        break;
-                    case SDLK_x:
-                        keys[0x00] = 0;
-                        break;
-                    case SDLK_1:
-                        keys[0x01] = 0;
-						break;
-                    case SDLK_2:
-                        keys[0x02] = 0;
-						break;
-                    case SDLK_3:
-                        keys[0x03] = 0;
-                        break;
-                    case SDLK_q:
-                        keys[0x04] = 0;
-                        break;
-                    case SDLK_w:
-                        keys[0x05] = 0;
-                        break;
-                    case SDLK_e:
-                        keys[0x06] = 0;
-                        break;
-                    case SDLK_a:
-                        keys[0x07] = 0;
-                        break;
-                    case SDLK_s:
-                        keys[0x08] = 0;
-                        break;
-                    case SDLK_d:
-                        keys[0x09] = 0;
-                        break;
-                    case SDLK_z:
-                        keys[0x0A] = 0;
-                        break;
-                    case SDLK_c:
-                        keys[0x0B] = 0;
-                        break;
-                    case SDLK_4:
-                        keys[0x0C] = 0;
-                        break;
-                    case SDLK_r:
-                        keys[0x0D] = 0;
-                        break;
-                    case SDLK_f:
-                        keys[0x0E] = 0;
-                        break;
-                    case SDLK_v:
-                        keys[0x0F] = 0;
-                        break;
+                if(event.key.keysym.sym == SDLK_ESCAPE) {
+                    quit = true;
+                    break;
+                }
+                // Held keys auto-repeat; only the first press is a transition
+                if(event.key.repeat)
+                    break;
+                // Look up the CHIP-8 key bound to the host key
+                for(uint8_t key = 0; key < 16; key++) {
+                    if(keymap_[key] == event.key.keysym.sym) {
+                        input.push({ event.key.timestamp, key, event.type == SDL_KEYDOWN });
+                        break;
+                    }
                 }
                 break;
             }
@@ -151,3 +81,7 @@ bool Renderer::processInput(uint8_t* keys) {
     }
     return quit;
 }
+// Milliseconds Since SDL Was Initialised, the Clock Used by Event Timestamps
+uint32_t Renderer::ticks() const {
+    return SDL_GetTicks();
+}
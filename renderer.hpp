@@ -4,19 +4,30 @@
 #include <cstdint>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_render.h>
+#include "input.hpp"
+#include "upscaler.hpp"
 
 class Renderer {
     private:
         SDL_Window* window_;                                                // SDL Object Representing the Window
         SDL_Renderer* renderer_;                                            // SDL Object Represnting the 2D Rendering Context for a Window
         SDL_Texture* texture_;                                              // SDL Object Representing the Texture the Window Uses
+        Upscaler upscaler_;                                                 // Upscales Each Frame on the CPU into the Output-Sized Texture
+        SDL_Keycode keymap_[16] = {                                         // Host Key Bound to Each CHIP-8 Key (0x0 to 0xF)
+            SDLK_x, SDLK_1, SDLK_2, SDLK_3,
+            SDLK_q, SDLK_w, SDLK_e, SDLK_a,
+            SDLK_s, SDLK_d, SDLK_z, SDLK_c,
+            SDLK_4, SDLK_r, SDLK_f, SDLK_v
+        };
     public:
         Renderer(const char* title, int windowWidth, int windowHeight,      // Creates Display Window
-            int textureWidth, int textureHeight);
+            int textureWidth, int textureHeight, UpscaleFilter filter);
         ~Renderer();                                                        // Destroy each field object and stops displaying graphics
 
         void update(const void* buffer, int pitch);                         // Update the Display with New Information
-        bool processInput(uint8_t* keys);                                   // Decide Action for each Key
+        bool mapKeys(const char* layout);                                   // Rebind Keys from 16 Characters, One per CHIP-8 Key in Order 0x0 to 0xF
+        bool processInput(InputQueue& input);                               // Queue Key Events; Returns True When the Emulator Should Quit
+        uint32_t ticks() const;                                             // Milliseconds Since SDL Was Initialised, the Clock Used by Event Timestamps
 };
 
 #endif
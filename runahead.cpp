@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include "chip8.hpp"
+#include "runahead.hpp"
+
+// Starts the Worker Unless frames is 0
+RunAhead::RunAhead(int frames) : frames_(frames < 0 ? 0 : frames) {
+    if(frames_ > 0)
+        worker_ = std::thread(&RunAhead::work, this);
+}
+// Stops and Joins the Worker
+RunAhead::~RunAhead() {
+    if(worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        signal_.notify_all();
+        worker_.join();
+    }
+}
+
+// Is Run-Ahead Turned On?
+bool RunAhead::enabled() const {
+    return frames_ > 0;
+}
+/*
+    Hand the Current State to the Worker and Return the Latest Finished Frame
+    The frame-time cost is everything this adds to the frame: the snapshot, plus waiting for the worker if it is still busy
+    with the previous snapshot. Until the first speculative frame finishes, the real frame is presented.
+*/
+const uint32_t* RunAhead::run(const Chip8& chip8) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // The worker only ever reads the snapshot it was last handed, so the other one can be written while it runs
+    chip8.saveState(states_[nextState_]);
+
+    const uint32_t* frame = chip8.video;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if(pending_) {
+            waitCount_++;
+            signal_.wait(lock, [this]() { return !pending_; });
+        }
+        // The worker writes the other frame buffer next, so this one stays intact while it is presented
+        if(videoReady_)
+            frame = video_[latestVideo_];
+        workState_ = nextState_;
+        pending_ = true;
+    }
+    signal_.notify_all();
+    nextState_ ^= 1;
+
+    uint64_t cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+    frameCount_++;
+    totalCost_ += cost;
+    if(cost > maxCost_)
+        maxCost_ = cost;
+
+    return frame;
+}
+
+// Number of Frames Run Ahead so Far
+uint64_t RunAhead::frameCount() const {
+    return frameCount_;
+}
+// Average Frame-Time Cost in Microseconds
+double RunAhead::averageCost() const {
+    return frameCount_ ? static_cast<double>(totalCost_) / frameCount_ : 0.0;
+}
+// Largest Frame-Time Cost in Microseconds
+uint64_t RunAhead::maxCost() const {
+    return maxCost_;
+}
+// Number of Frames That Had to Wait for the Worker
+uint64_t RunAhead::waitCount() const {
+    return waitCount_;
+}
+
+// Worker Loop: Wait for a Snapshot, Run it Ahead, Report Back
+void RunAhead::work() {
+    while(true) {
+        int state;
+        int video;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            signal_.wait(lock, [this]() { return pending_ || stopping_; });
+            if(stopping_)
+                return;
+            state = workState_;
+            video = latestVideo_ ^ 1;
+        }
+
+        // Restore the snapshot into the shadow CHIP-8 and run it ahead with the same keys held; the extra frame covers the
+        // frame the real CHIP-8 runs before this result is presented
+        shadow_.loadState(states_[state]);
+        for(int i = 0; i < frames_ + 1; i++)
+            shadow_.cycle();
+        memcpy(video_[video], shadow_.video, sizeof(video_[video]));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            latestVideo_ = video;
+            videoReady_ = true;
+            pending_ = false;
+        }
+        signal_.notify_all();
+    }
+}
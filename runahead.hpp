@@ -0,0 +1,55 @@
+#ifndef RUNAHEAD_HPP
+#define RUNAHEAD_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "chip8.hpp"
+
+/*
+    Run-ahead latency reduction
+    Every frame the real CHIP-8 is snapshotted and a second instance on a worker thread runs the snapshot a few frames ahead
+    with the input currently held. The two are pipelined: while the worker runs one snapshot, the main thread keeps emulating
+    and presents the most recently finished speculative frame, which was started from the previous frame's snapshot. The
+    worker runs one extra frame to make up for that, so what is shown is exactly frames_ frames ahead of the real CHIP-8.
+    Snapshots and finished frames are double-buffered so neither side writes what the other is reading, and the main thread
+    only waits when the worker has not finished the previous snapshot by the time the next one is ready.
+*/
+class RunAhead {
+    private:
+        int frames_;                                                    // Number of Frames the Presented Frame is Ahead, 0 Disables Run-Ahead
+        Chip8 shadow_;                                                  // Second CHIP-8 That Runs the Speculative Frames
+        Chip8State states_[2];                                          // Snapshots; the Worker Reads One While the Main Thread Writes the Other
+        uint32_t video_[2][2048];                                       // Finished Frames; One Being Presented While the Worker Writes the Other
+        int nextState_ = 0;                                             // Snapshot the Main Thread Writes Next
+        int workState_ = 0;                                             // Snapshot Handed to the Worker
+        int latestVideo_ = 0;                                           // Most Recently Finished Frame
+        bool videoReady_ = false;                                       // Has Any Speculative Frame Finished Yet?
+
+        std::thread worker_;                                            // Thread Running the Shadow CHIP-8
+        std::mutex mutex_;                                              // Guards the Flags Below
+        std::condition_variable signal_;                                // Wakes the Worker or the Main Thread When a Flag Changes
+        bool pending_ = false;                                          // Has a Snapshot Been Handed Over That the Worker Has Not Finished?
+        bool stopping_ = false;                                         // Should the Worker Exit?
+
+        uint64_t frameCount_ = 0;                                       // Number of Frames Run Ahead so Far
+        uint64_t totalCost_ = 0;                                        // Sum of Per-Frame Costs in Microseconds
+        uint64_t maxCost_ = 0;                                          // Largest Per-Frame Cost in Microseconds
+        uint64_t waitCount_ = 0;                                        // Number of Frames That Had to Wait for the Worker
+
+        void work();                                                    // Worker Loop: Wait for a Snapshot, Run it Ahead, Report Back
+    public:
+        RunAhead(int frames);                                           // Starts the Worker Unless frames is 0
+        ~RunAhead();                                                    // Stops and Joins the Worker
+
+        bool enabled() const;                                           // Is Run-Ahead Turned On?
+        const uint32_t* run(const Chip8& chip8);                        // Hand the Current State to the Worker and Return the Latest Finished Frame
+
+        uint64_t frameCount() const;                                    // Number of Frames Run Ahead so Far
+        double averageCost() const;                                     // Average Frame-Time Cost in Microseconds
+        uint64_t maxCost() const;                                       // Largest Frame-Time Cost in Microseconds
+        uint64_t waitCount() const;                                     // Number of Frames That Had to Wait for the Worker
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "chip8.hpp"
+#include "search.hpp"
+
+/*
+    Diff encoding: a sequence of records, each a 16-bit little-endian byte offset into Chip8State, a 16-bit little-endian
+    length, then that many bytes of the child's state. Applying every record to a copy of the parent's state gives the child's.
+*/
+
+static_assert(std::is_trivially_copyable_v<Chip8State>, "Chip8State is diffed and copied as raw bytes");
+static_assert(sizeof(Chip8State) <= 0xFFFFu, "Diff offsets are 16 bits");
+
+const size_t DIFF_BLOCK = 8;        // Bytes Compared at Once When Looking for Changes
+
+// Append the changes from parent to child to diff
+static void encodeDiff(const Chip8State& parent, const Chip8State& child, std::vector<uint8_t>& diff) {
+    const uint8_t* before = reinterpret_cast<const uint8_t*>(&parent);
+    const uint8_t* after = reinterpret_cast<const uint8_t*>(&child);
+    const size_t size = sizeof(Chip8State);
+
+    size_t offset = 0;
+    while(offset < size) {
+        // Skip unchanged blocks, then unchanged bytes
+        size_t block = std::min(DIFF_BLOCK, size - offset);
+        if(memcmp(before + offset, after + offset, block) == 0) {
+            offset += block;
+            continue;
+        }
+        while(before[offset] == after[offset])
+            offset++;
+
+        // Extend the run while bytes differ, allowing short equal gaps so runs do not fragment
+        size_t end = offset;
+        size_t equal = 0;
+        while(end < size && equal < 4) {
+            equal = before[end] == after[end] ? equal + 1 : 0;
+            end++;
+        }
+        end -= equal;
+
+        size_t length = end - offset;
+        diff.push_back(offset & 0xFFu);
+        diff.push_back(offset >> 8);
+        diff.push_back(length & 0xFFu);
+        diff.push_back(length >> 8);
+        diff.insert(diff.end(), after + offset, after + end);
+        offset = end;
+    }
+}
+// Apply a diff made by encodeDiff to a copy of the parent's state
+static void applyDiff(const std::vector<uint8_t>& diff, Chip8State& state) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&state);
+    size_t position = 0;
+    while(position < diff.size()) {
+        size_t offset = diff[position] | (diff[position + 1] << 8);
+        size_t length = diff[position + 2] | (diff[position + 3] << 8);
+        memcpy(bytes + offset, diff.data() + position + 4, length);
+        position += 4 + length;
+    }
+}
+// Mix a run of bytes into a hash eight bytes at a time
+static uint64_t mix(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3u;
+        hash ^= hash >> 29;
+    }
+    for(; i < size; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001B3u;
+    return hash;
+}
+
+// Creates a Search with the Given Options
+StateSearch::StateSearch(const SearchOptions& options) : options_(options) {
+    if(options_.threads == 0)
+        options_.threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Search from the Given State, Replacing Any Earlier Results
+void StateSearch::run(const Chip8& root) {
+    nodes_.clear();
+    seen_.clear();
+
+    root.saveState(root_);
+    uint64_t rootHash = hash(root_);
+    seen_.insert(rootHash);
+    nodes_.push_back({ SearchNode::NO_PARENT, SearchNode::NO_KEY, 0, rootHash, {} });
+
+    size_t levelStart = 0;
+    size_t levelEnd = nodes_.size();
+
+    for(int depth = 0; depth < options_.maxDepth && levelStart < levelEnd && nodes_.size() < options_.maxStates; depth++) {
+        for(size_t first = levelStart; first < levelEnd && nodes_.size() < options_.maxStates; first += BATCH_PARENTS) {
+            size_t last = std::min(levelEnd, first + BATCH_PARENTS);
+            std::vector<std::vector<SearchNode>> children(last - first);
+            expand(first, last, depth, children);
+
+            // Merge in (parent, input) order, so when two children reach the same state the same one is kept on every run
+            for(std::vector<SearchNode>& list : children) {
+                for(SearchNode& node : list) {
+                    if(nodes_.size() >= options_.maxStates)
+                        break;
+                    if(seen_.insert(node.hash).second)
+                        nodes_.push_back(std::move(node));
+                }
+            }
+        }
+
+        // The next level is everything this one produced
+        levelStart = levelEnd;
+        levelEnd = nodes_.size();
+    }
+}
+// Every Distinct State Found, Root First
+const std::vector<SearchNode>& StateSearch::nodes() const {
+    return nodes_;
+}
+// Rebuild the Full State of a Node from the Root and its Diffs
+void StateSearch::reconstruct(uint32_t node, Chip8State& state) const {
+    // Walk up to the root, then apply the diffs on the way back down
+    std::vector<uint32_t> chain;
+    chain.reserve(nodes_[node].depth);
+    for(uint32_t i = node; nodes_[i].parent != SearchNode::NO_PARENT; i = nodes_[i].parent)
+        chain.push_back(i);
+
+    state = root_;
+    for(auto i = chain.rbegin(); i != chain.rend(); i++)
+        applyDiff(nodes_[*i].diff, state);
+}
+// Keys Tapped on the Way from the Root to a Node
+std::vector<uint8_t> StateSearch::inputs(uint32_t node) const {
+    std::vector<uint8_t> keys;
+    for(uint32_t i = node; nodes_[i].parent != SearchNode::NO_PARENT; i = nodes_[i].parent)
+        keys.push_back(nodes_[i].input);
+    std::reverse(keys.begin(), keys.end());
+    return keys;
+}
+
+/*
+    Hash of Memory, Registers and Video
+    Registers covers everything in the CPU: V0-VF, I, the program counter, the stack and the timers, since states differing
+    only there behave differently. The RNG is left out so paths that did not draw random numbers still deduplicate.
+*/
+uint64_t StateSearch::hash(const Chip8State& state) {
+    uint64_t hash = 0xCBF29CE484222325u;
+    hash = mix(hash, state.memory, sizeof(state.memory));
+    hash = mix(hash, state.registers, sizeof(state.registers));
+    hash = mix(hash, state.video, sizeof(state.video));
+    hash = mix(hash, state.stack, sizeof(state.stack));
+    uint16_t cpu[] = { state.index, state.programCounter, state.stackPointer, state.delayTimer, state.soundTimer,
+        state.keyReleases, state.waitingForKey };
+    return mix(hash, cpu, sizeof(cpu));
+}
+
+/*
+    Expand Parents first to last - 1 Across All Threads
+    Workers take parents one at a time and put each parent's children, in input order, in that parent's own list. Nothing is
+    written to nodes_ or seen_ while they run, so both can be read without locks; children already found on an earlier batch
+    are dropped here, while duplicates within the batch are left for the merge to resolve in a fixed order.
+*/
+void StateSearch::expand(size_t first, size_t last, int depth, std::vector<std::vector<SearchNode>>& children) const {
+    std::atomic<size_t> next = first;
+    std::vector<std::thread> workers;
+
+    for(unsigned int t = 0; t < options_.threads; t++) {
+        workers.emplace_back([&]() {
+            Chip8 chip8(0);
+            // Two full states per worker; too large to want on every thread's stack
+            std::vector<Chip8State> states(2);
+            Chip8State& parentState = states[0];
+            Chip8State& childState = states[1];
+
+            for(size_t parent = next++; parent < last; parent = next++) {
+                reconstruct(parent, parentState);
+
+                for(uint8_t input = 0; input <= SearchNode::NO_KEY; input++) {
+                    // Tap the key for one frame
+                    chip8.loadState(parentState);
+                    if(input != SearchNode::NO_KEY)
+                        chip8.pressKey(input);
+                    for(int cycle = 0; cycle < options_.cyclesPerFrame; cycle++)
+                        chip8.cycle();
+                    if(input != SearchNode::NO_KEY)
+                        chip8.releaseKey(input);
+                    chip8.saveState(childState);
+
+                    uint64_t childHash = hash(childState);
+                    if(seen_.count(childHash))
+                        continue;
+
+                    SearchNode node { static_cast<uint32_t>(parent), input, static_cast<uint16_t>(depth + 1), childHash, {} };
+                    encodeDiff(parentState, childState, node.diff);
+                    children[parent - first].push_back(std::move(node));
+                }
+            }
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+}
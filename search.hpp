@@ -0,0 +1,59 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include "chip8.hpp"
+
+// Options Controlling a Search
+struct SearchOptions {
+    int cyclesPerFrame = 10;                                            // Cycles Each Child Runs Headlessly Before Becoming a State
+    int maxDepth = 16;                                                  // Deepest Level Expanded (the Root is Level 0)
+    uint64_t maxStates = 1000000;                                       // Stop Once This Many Distinct States Have Been Found
+    unsigned int threads = 0;                                           // Worker Threads, 0 for One per Hardware Thread
+};
+
+// A Distinct State Reached by the Search
+struct SearchNode {
+    static const uint32_t NO_PARENT = 0xFFFFFFFFu;                      // Parent of the Root
+    static const uint8_t NO_KEY = 16;                                   // Input Meaning No Key Was Tapped
+
+    uint32_t parent;                                                    // Index of the Parent Node
+    uint8_t input;                                                      // Key Tapped During the Frame from the Parent (0x0 to 0xF, or NO_KEY)
+    uint16_t depth;                                                     // Number of Frames from the Root
+    uint64_t hash;                                                      // Hash of the State, Used for Deduplication
+    std::vector<uint8_t> diff;                                          // Changes from the Parent's State, see search.cpp for the Encoding
+};
+
+/*
+    Breadth-first search over every keypad input
+    Each state is expanded into 17 children: one per key tapped for a frame, plus one with no key. Children run headlessly,
+    are deduplicated by a hash of memory, registers and video, and are stored as diffs against their parent so a node costs
+    a few dozen bytes instead of a full 12 KB state. Each level is expanded across all cores in batches of parents, and every
+    batch is merged on one thread in (parent, input) order, so the node list is the same for any thread count or schedule.
+*/
+class StateSearch {
+    private:
+        static const size_t BATCH_PARENTS = 1024;                       // Parents Expanded in Parallel Before Their Children are Merged
+
+        SearchOptions options_;                                         // Options for This Search
+        Chip8State root_;                                               // Full State of the Root, Which All Diffs Build On
+        std::vector<SearchNode> nodes_;                                 // Every Distinct State Found, in Breadth-First Order
+        std::unordered_set<uint64_t> seen_;                             // Hashes of Every State Found; Only Written Between Batches
+
+        // Expand Parents first to last - 1 Across All Threads
+        void expand(size_t first, size_t last, int depth, std::vector<std::vector<SearchNode>>& children) const;
+    public:
+        StateSearch(const SearchOptions& options);                      // Creates a Search with the Given Options
+
+        void run(const Chip8& root);                                    // Search from the Given State, Replacing Any Earlier Results
+        const std::vector<SearchNode>& nodes() const;                   // Every Distinct State Found, Root First
+        void reconstruct(uint32_t node, Chip8State& state) const;       // Rebuild the Full State of a Node from the Root and its Diffs
+        std::vector<uint8_t> inputs(uint32_t node) const;               // Keys Tapped on the Way from the Root to a Node
+
+        static uint64_t hash(const Chip8State& state);                  // Hash of Memory, Registers and Video
+};
+
+#endif
@@ -0,0 +1,101 @@
+; arith.ch8 - 8xy1 to 8xy7 and 8xyE results and VF flags
+; Each result is copied to V3 and drawn as three decimal digits at (VA, VB) by the show subroutine.
+; Expected screen, left to right and top to bottom:
+;   row 0:  044 001 254      200+100 wraps to 44 with carry 1; 3-5 (SUBN) wraps to 254
+;   row 6:  246 000 000      10-20 (SUB) wraps to 246 with VF 0 (borrow); SUBN set VF 0 (borrow)
+;   row 12: 064 001 252      0x81 SHR 1 is 64, shifting out a 1; 0xF0 OR 0x3C is 252
+;   row 18: 130 001 000      0xC1 SHL 1 is 130 (0x182 truncated), shifting out a 1; X AND X XOR X is 0
+
+        CLS
+        LD V4, 200
+        LD V5, 100
+        ADD V4, V5              ; 8xy4: V4 = 44, VF = 1 (carry)
+        LD V6, VF
+        LD V7, 10
+        LD V8, 20
+        SUB V7, V8              ; 8xy5: V7 = 246, VF = 0 (borrow)
+        LD V9, VF
+        LD VA, 0
+        LD VB, 0
+        LD V3, V4
+        CALL show               ; 044 at (0, 0)
+        LD VA, 20
+        LD VB, 0
+        LD V3, V6
+        CALL show               ; 001 at (20, 0)
+        LD VA, 0
+        LD VB, 6
+        LD V3, V7
+        CALL show               ; 246 at (0, 6)
+        LD VA, 20
+        LD VB, 6
+        LD V3, V9
+        CALL show               ; 000 at (20, 6)
+
+        LD VC, 0x81
+        SHR VC                  ; 8xy6: VC = 64, VF = 1 (bit shifted out)
+        LD VD, VF
+        LD VA, 0
+        LD VB, 12
+        LD V3, VC
+        CALL show               ; 064 at (0, 12)
+        LD VA, 20
+        LD VB, 12
+        LD V3, VD
+        CALL show               ; 001 at (20, 12)
+
+        LD VC, 0xC1
+        SHL VC                  ; 8xyE: VC = 130, VF = 1 (bit shifted out)
+        LD VD, VF
+        LD VA, 0
+        LD VB, 18
+        LD V3, VC
+        CALL show               ; 130 at (0, 18)
+        LD VA, 20
+        LD VB, 18
+        LD V3, VD
+        CALL show               ; 001 at (20, 18)
+
+        LD VC, 5
+        LD VD, 3
+        SUBN VC, VD             ; 8xy7: VC = 3 - 5 = 254, VF = 0 (borrow)
+        LD VE, VF
+        LD VA, 40
+        LD VB, 0
+        LD V3, VC
+        CALL show               ; 254 at (40, 0)
+        LD VA, 40
+        LD VB, 6
+        LD V3, VE
+        CALL show               ; 000 at (40, 6)
+
+        LD VC, 0xF0
+        LD VD, 0x3C
+        OR VC, VD               ; 8xy1: VC = 0xFC = 252
+        LD VE, VD
+        AND VE, VD              ; 8xy2: VE = 0x3C
+        XOR VE, VD              ; 8xy3: VE = 0
+        LD VA, 40
+        LD VB, 12
+        LD V3, VC
+        CALL show               ; 252 at (40, 12)
+        LD VA, 40
+        LD VB, 18
+        LD V3, VE
+        CALL show               ; 000 at (40, 18)
+end:    JP end
+
+; Draw V3 as three decimal digits at (VA, VB); uses 0x300-0x302 as scratch and clobbers V0-V2, I and VA
+show:   LD I, 0x300
+        LD B, V3                ; Fx33: hundreds, tens, units at 0x300-0x302
+        LD V2, [I]              ; Fx65: V0-V2 = the digits
+        LD F, V0
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V1
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V2
+        DRW VA, VB, 5
+        ADD VA, 5
+        RET
@@ -0,0 +1,177 @@
+"""
+Assembler for the test ROMs in this directory
+Turns each <name>.asm into <name>.ch8 next to it: python3 tests/roms/assemble.py tests/roms/*.asm
+
+Syntax follows Cowgod's CHIP-8 reference, one instruction per line:
+    label:                  Names the address of the next instruction
+    CLS / RET               00E0 / 00EE
+    JP addr / JP V0, addr   1nnn / Bnnn
+    CALL addr               2nnn
+    SE / SNE Vx, byte|Vy    3xkk / 4xkk, 5xy0 / 9xy0
+    LD Vx, byte|Vy|DT|K|[I] 6xkk, 8xy0, Fx07, Fx0A, Fx65
+    LD I|DT|ST|F|B|[I], ... Annn, Fx15, Fx18, Fx29, Fx33, Fx55
+    ADD Vx, byte|Vy / ADD I, Vx                 7xkk, 8xy4 / Fx1E
+    OR / AND / XOR / SUB / SUBN Vx, Vy          8xy1 / 8xy2 / 8xy3 / 8xy5 / 8xy7
+    SHR / SHL Vx[, Vy]      8xy6 / 8xyE
+    RND Vx, byte            Cxkk
+    DRW Vx, Vy, n           Dxyn
+    SKP / SKNP Vx           Ex9E / ExA1
+    DB byte, ...            Raw bytes
+Numbers are decimal or 0x-prefixed hex; everything after a ; is a comment.
+"""
+
+import os
+import sys
+
+START_ADDRESS = 0x200
+KEYWORDS = ("I", "DT", "ST", "K", "F", "B", "[I]")
+
+
+class AssemblyError(Exception):
+    pass
+
+
+def register(token):
+    if len(token) == 2 and token[0] in "vV" and token[1] in "0123456789abcdefABCDEF":
+        return int(token[1], 16)
+    return None
+
+
+def number(token, labels, limit):
+    if token in labels:
+        value = labels[token]
+    else:
+        try:
+            value = int(token, 0)
+        except ValueError:
+            raise AssemblyError("bad number or unknown label: " + token)
+    if not 0 <= value <= limit:
+        raise AssemblyError("out of range: " + token)
+    return value
+
+
+def encode(mnemonic, operands, labels):
+    """Returns the bytes for one instruction"""
+    ops = [o.upper() if o.upper() in KEYWORDS else o for o in operands]
+    count = len(ops)
+    x = register(ops[0]) if count > 0 else None
+    y = register(ops[1]) if count > 1 else None
+
+    def word(value):
+        return bytes([value >> 8, value & 0xFF])
+
+    def byte(index):
+        return number(ops[index], labels, 0xFF)
+
+    def address(index):
+        return number(ops[index], labels, 0xFFF)
+
+    if mnemonic == "DB":
+        return bytes(number(o, labels, 0xFF) for o in ops)
+    if mnemonic == "CLS" and count == 0:
+        return word(0x00E0)
+    if mnemonic == "RET" and count == 0:
+        return word(0x00EE)
+    if mnemonic == "JP" and count == 1:
+        return word(0x1000 | address(0))
+    if mnemonic == "JP" and count == 2 and x == 0:
+        return word(0xB000 | address(1))
+    if mnemonic == "CALL" and count == 1:
+        return word(0x2000 | address(0))
+    if mnemonic in ("SE", "SNE") and count == 2 and x is not None:
+        if y is not None:
+            return word((0x5000 if mnemonic == "SE" else 0x9000) | x << 8 | y << 4)
+        return word((0x3000 if mnemonic == "SE" else 0x4000) | x << 8 | byte(1))
+    if mnemonic == "LD" and count == 2:
+        if x is not None:
+            if y is not None:
+                return word(0x8000 | x << 8 | y << 4)
+            if ops[1] == "DT":
+                return word(0xF007 | x << 8)
+            if ops[1] == "K":
+                return word(0xF00A | x << 8)
+            if ops[1] == "[I]":
+                return word(0xF065 | x << 8)
+            return word(0x6000 | x << 8 | byte(1))
+        if ops[0] == "I":
+            return word(0xA000 | address(1))
+        source = register(ops[1])
+        codes = {"DT": 0xF015, "ST": 0xF018, "F": 0xF029, "B": 0xF033, "[I]": 0xF055}
+        if source is not None and ops[0] in codes:
+            return word(codes[ops[0]] | source << 8)
+    if mnemonic == "ADD" and count == 2:
+        if ops[0] == "I" and y is not None:
+            return word(0xF01E | y << 8)
+        if x is not None and y is not None:
+            return word(0x8004 | x << 8 | y << 4)
+        if x is not None:
+            return word(0x7000 | x << 8 | byte(1))
+    logic = {"OR": 1, "AND": 2, "XOR": 3, "SUB": 5, "SUBN": 7}
+    if mnemonic in logic and count == 2 and x is not None and y is not None:
+        return word(0x8000 | x << 8 | y << 4 | logic[mnemonic])
+    if mnemonic in ("SHR", "SHL") and count in (1, 2) and x is not None and (count == 1 or y is not None):
+        return word(0x8000 | x << 8 | (y or 0) << 4 | (0x6 if mnemonic == "SHR" else 0xE))
+    if mnemonic == "RND" and count == 2 and x is not None:
+        return word(0xC000 | x << 8 | byte(1))
+    if mnemonic == "DRW" and count == 3 and x is not None and y is not None:
+        return word(0xD000 | x << 8 | y << 4 | number(ops[2], labels, 0xF))
+    if mnemonic in ("SKP", "SKNP") and count == 1 and x is not None:
+        return word((0xE09E if mnemonic == "SKP" else 0xE0A1) | x << 8)
+    raise AssemblyError("unknown instruction: " + " ".join([mnemonic] + operands))
+
+
+def parse(path):
+    """Returns (line number, label or None, mnemonic or None, operands) for every line"""
+    lines = []
+    with open(path) as source:
+        for lineNumber, text in enumerate(source, 1):
+            text = text.split(";", 1)[0].strip()
+            label = None
+            if ":" in text:
+                label, text = (part.strip() for part in text.split(":", 1))
+            mnemonic, _, rest = text.partition(" ")
+            operands = [o.strip() for o in rest.split(",")] if rest.strip() else []
+            lines.append((lineNumber, label, mnemonic.upper() or None, operands))
+    return lines
+
+
+def assemble(path):
+    lines = parse(path)
+    # First pass: place the labels, assuming every forward reference fits
+    labels = {}
+    address = START_ADDRESS
+    placeholders = {}
+    for lineNumber, label, mnemonic, operands in lines:
+        if label:
+            labels[label] = address
+        if mnemonic:
+            placeholders.update({o: 0 for o in operands if o[:1].isalpha() and register(o) is None and o.upper() not in KEYWORDS})
+            address += len(encode(mnemonic, operands, {**placeholders, **labels}))
+    # Second pass: encode with every label known
+    image = bytearray()
+    for lineNumber, label, mnemonic, operands in lines:
+        if mnemonic:
+            try:
+                image += encode(mnemonic, operands, labels)
+            except AssemblyError as error:
+                raise AssemblyError("%s:%d: %s" % (path, lineNumber, error))
+    return bytes(image)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("Usage: %s <file.asm> ...\n" % sys.argv[0])
+        return 1
+    for path in sys.argv[1:]:
+        try:
+            image = assemble(path)
+        except AssemblyError as error:
+            sys.stderr.write("%s\n" % error)
+            return 1
+        with open(os.path.splitext(path)[0] + ".ch8", "wb") as rom:
+            rom.write(image)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,8 @@
+; clip.ch8 - Dxyn clipping at the bottom-right corner
+; Draws a 15-row sprite at (62, 30): only the top-left 2x2 pixels of it are on screen, and nothing wraps to the other edges.
+
+        LD V0, 62
+        LD V1, 30
+        LD I, 0x050             ; the font data, used as an arbitrary 15-byte sprite
+        DRW V0, V1, 15
+end:    JP end
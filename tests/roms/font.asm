@@ -0,0 +1,13 @@
+; font.ch8 - Fx29 and Dxyn for all 16 font characters
+; Expected screen: the characters 0 to F on a diagonal, character n at (4n, 4n) with the start row wrapping at 32, so 8 to
+; F start again from the top; sprites that run off the bottom are clipped.
+
+        LD V1, 0                ; character
+        LD V2, 0                ; x and y position
+next:   LD F, V1                ; Fx29: I = sprite for the character in V1
+        DRW V2, V2, 5
+        ADD V1, 1
+        ADD V2, 4
+        SE V1, 16
+        JP next
+end:    JP end
@@ -0,0 +1,47 @@
+; keypad.ch8 - Fx0A, Ex9E and ExA1 driven by the key events scripted in the manifest
+; Each result is copied to V3 and drawn as three decimal digits at (VA, VB) by the show subroutine.
+; Expected screen:
+;   nothing until key 7 is released, since Fx0A waits for a full press and release
+;   row 0:  007 nnn mmm      the key Fx0A returned; loop iterations before key A was pressed; iterations while it was held
+; The key register holds 0x1A, so the skips only see key A if they use the low nibble alone.
+
+        CLS
+        LD V3, K                ; Fx0A: waits for a key to be pressed and released
+        LD VA, 0
+        LD VB, 0
+        CALL show               ; 007 at (0, 0)
+
+        LD V4, 0
+        LD V6, 0x1A             ; key A, with a high nibble that must be ignored
+up:     ADD V4, 1
+        SKP V6                  ; Ex9E: leave the loop once A is held
+        JP up
+        LD VA, 20
+        LD VB, 0
+        LD V3, V4
+        CALL show               ; iterations while A was up, at (20, 0)
+
+        LD V5, 0
+held:   ADD V5, 1
+        SKNP V6                 ; ExA1: leave the loop once A is released
+        JP held
+        LD VA, 40
+        LD VB, 0
+        LD V3, V5
+        CALL show               ; iterations while A was held, at (40, 0)
+end:    JP end
+
+; Draw V3 as three decimal digits at (VA, VB); uses 0x300-0x302 as scratch and clobbers V0-V2, I and VA
+show:   LD I, 0x300
+        LD B, V3                ; Fx33: hundreds, tens, units at 0x300-0x302
+        LD V2, [I]              ; Fx65: V0-V2 = the digits
+        LD F, V0
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V1
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V2
+        DRW VA, VB, 5
+        ADD VA, 5
+        RET
@@ -0,0 +1,78 @@
+; memory.ch8 - Fx55/Fx65 round trip, Fx1E and the skip instructions
+; Each result is copied to V3 and drawn as three decimal digits at (VA, VB) by the show subroutine.
+; Expected screen, left to right and top to bottom:
+;   row 0:  017 034 051      V4-V6 stored with Fx55, cleared, and reloaded with Fx65
+;   row 6:  017              the byte at 0x400 + 4 read back through Fx1E
+;   row 12: 099 042          3xkk and 5xy0 skipped a reset; 4xkk and 9xy0 did not skip the final load (000 if the
+;                            equal skips fail, the original value if the not-equal skips fire)
+
+        CLS
+        LD V4, 0x11
+        LD V5, 0x22
+        LD V6, 0x33
+        LD I, 0x400
+        LD [I], V6              ; Fx55: V0-V6 to 0x400-0x406
+        LD V4, 0
+        LD V5, 0
+        LD V6, 0
+        LD I, 0x400
+        LD V6, [I]              ; Fx65: V0-V6 back from 0x400-0x406
+        LD VA, 0
+        LD VB, 0
+        LD V3, V4
+        CALL show               ; 017 at (0, 0)
+        LD VA, 20
+        LD VB, 0
+        LD V3, V5
+        CALL show               ; 034 at (20, 0)
+        LD VA, 40
+        LD VB, 0
+        LD V3, V6
+        CALL show               ; 051 at (40, 0)
+
+        LD I, 0x400
+        LD V7, 4
+        ADD I, V7               ; Fx1E: I = 0x404, where V4 was stored
+        LD V0, [I]
+        LD V4, V0
+        LD VA, 0
+        LD VB, 6
+        LD V3, V4
+        CALL show               ; 017 at (0, 6)
+
+        LD VC, 7
+        SE VC, 7                ; 3xkk: equal, so the next instruction is skipped
+        LD VC, 0
+        SNE VC, 7               ; 4xkk: equal, so the next instruction runs
+        LD VC, 99
+        LD VA, 0
+        LD VB, 12
+        LD V3, VC
+        CALL show               ; 099 at (0, 12)
+
+        LD VD, 5
+        LD VE, 5
+        SE VD, VE               ; 5xy0: equal, so the next instruction is skipped
+        LD VD, 0
+        SNE VD, VE              ; 9xy0: equal, so the next instruction runs
+        LD VD, 42
+        LD VA, 20
+        LD VB, 12
+        LD V3, VD
+        CALL show               ; 042 at (20, 12)
+end:    JP end
+
+; Draw V3 as three decimal digits at (VA, VB); uses 0x300-0x302 as scratch and clobbers V0-V2, I and VA
+show:   LD I, 0x300
+        LD B, V3                ; Fx33: hundreds, tens, units at 0x300-0x302
+        LD V2, [I]              ; Fx65: V0-V2 = the digits
+        LD F, V0
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V1
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V2
+        DRW VA, VB, 5
+        ADD VA, 5
+        RET
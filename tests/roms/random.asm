@@ -0,0 +1,8 @@
+; random.ch8 - Cxkk with the runner's fixed seed
+; Draws a font character at a random position, forever, so the screen depends on every random byte drawn so far.
+
+loop:   RND V0, 0x3F            ; x in 0-63, also the character (only the low nibble selects it)
+        RND V1, 0x1F            ; y in 0-31
+        LD F, V0
+        DRW V0, V1, 5
+        JP loop
@@ -0,0 +1,41 @@
+; timer.ch8 - Delay timer countdown observed through Fx07, and Fx18
+; The delay timer drops by one per cycle in this emulator, so the loop below runs once per tick it takes to reach 0.
+; Expected screen:
+;   row 0:  008              30 ticks at the loop's four cycles per iteration, rounded up
+;   row 6:  000              the delay timer read back once it has run out
+
+        CLS
+        LD V4, 0
+        LD VC, 30
+        LD DT, VC               ; Fx15: DT = 30
+loop:   ADD V4, 1               ; count iterations
+        LD VD, DT               ; Fx07
+        SE VD, 0
+        JP loop
+        LD VA, 0
+        LD VB, 0
+        LD V3, V4
+        CALL show               ; 008 at (0, 0)
+        LD VC, 15
+        LD ST, VC               ; Fx18: no visible effect, but must not disturb DT
+        LD V5, DT
+        LD VA, 0
+        LD VB, 6
+        LD V3, V5
+        CALL show               ; 000 at (0, 6)
+end:    JP end
+
+; Draw V3 as three decimal digits at (VA, VB); uses 0x300-0x302 as scratch and clobbers V0-V2, I and VA
+show:   LD I, 0x300
+        LD B, V3                ; Fx33: hundreds, tens, units at 0x300-0x302
+        LD V2, [I]              ; Fx65: V0-V2 = the digits
+        LD F, V0
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V1
+        DRW VA, VB, 5
+        ADD VA, 5
+        LD F, V2
+        DRW VA, VB, 5
+        ADD VA, 5
+        RET
@@ -0,0 +1,227 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include "upscaler.hpp"
+
+/*
+    AVX2 kernels are compiled with a target attribute and only called after a runtime CPU check, so the default build
+    (plain -std=c++20) still uses them on CPUs that have AVX2. SSE2 is part of the x86-64 baseline and needs no check.
+    The scalar kernels are always built, so the vector ones can be checked against them (see bin/regress).
+*/
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define UPSCALER_AVX2
+#endif
+#if defined(__SSE2__)
+#define UPSCALER_SSE2
+#endif
+
+const uint32_t COLOUR_MASK = 0x7F7F7F00u;   // Colour Channels After Halving (Pixels are RGBA8888, so Alpha is the Lowest Byte)
+const uint32_t ALPHA_MASK = 0x000000FFu;    // Alpha Channel
+
+// Fill count pixels starting at destination with the same value, one at a time
+static void fillSpanScalar(uint32_t* destination, uint32_t pixel, int count) {
+    for(int i = 0; i < count; i++)
+        destination[i] = pixel;
+}
+// Halve the colour channels of count pixels in place, leaving alpha untouched, one at a time
+static void darkenSpanScalar(uint32_t* pixels, int count) {
+    for(int i = 0; i < count; i++)
+        pixels[i] = ((pixels[i] >> 1) & COLOUR_MASK) | (pixels[i] & ALPHA_MASK);
+}
+#ifdef UPSCALER_SSE2
+// Fill count pixels starting at destination with the same value, four at a time
+static void fillSpanSse2(uint32_t* destination, uint32_t pixel, int count) {
+    int i = 0;
+    __m128i narrow = _mm_set1_epi32(static_cast<int>(pixel));
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), narrow);
+    fillSpanScalar(destination + i, pixel, count - i);
+}
+// Halve the colour channels of count pixels in place, leaving alpha untouched, four at a time
+static void darkenSpanSse2(uint32_t* pixels, int count) {
+    int i = 0;
+    __m128i narrowColour = _mm_set1_epi32(static_cast<int>(COLOUR_MASK));
+    __m128i narrowAlpha = _mm_set1_epi32(static_cast<int>(ALPHA_MASK));
+    for(; i + 4 <= count; i += 4) {
+        __m128i* address = reinterpret_cast<__m128i*>(pixels + i);
+        __m128i value = _mm_loadu_si128(address);
+        __m128i colour = _mm_and_si128(_mm_srli_epi32(value, 1), narrowColour);
+        _mm_storeu_si128(address, _mm_or_si128(colour, _mm_and_si128(value, narrowAlpha)));
+    }
+    darkenSpanScalar(pixels + i, count - i);
+}
+#endif
+#ifdef UPSCALER_AVX2
+// Fill count pixels starting at destination with the same value, eight at a time
+__attribute__((target("avx2")))
+static void fillSpanAvx2(uint32_t* destination, uint32_t pixel, int count) {
+    int i = 0;
+    __m256i wide = _mm256_set1_epi32(static_cast<int>(pixel));
+    for(; i + 8 <= count; i += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), wide);
+    fillSpanScalar(destination + i, pixel, count - i);
+}
+// Halve the colour channels of count pixels in place, leaving alpha untouched, eight at a time
+__attribute__((target("avx2")))
+static void darkenSpanAvx2(uint32_t* pixels, int count) {
+    int i = 0;
+    __m256i wideColour = _mm256_set1_epi32(static_cast<int>(COLOUR_MASK));
+    __m256i wideAlpha = _mm256_set1_epi32(static_cast<int>(ALPHA_MASK));
+    for(; i + 8 <= count; i += 8) {
+        __m256i* address = reinterpret_cast<__m256i*>(pixels + i);
+        __m256i value = _mm256_loadu_si256(address);
+        __m256i colour = _mm256_and_si256(_mm256_srli_epi32(value, 1), wideColour);
+        _mm256_storeu_si256(address, _mm256_or_si256(colour, _mm256_and_si256(value, wideAlpha)));
+    }
+    darkenSpanScalar(pixels + i, count - i);
+}
+#endif
+
+// Creates an Upscaler for a Fixed Source Size and Scale; Unsupported Kernel Sets Fall Back to Best
+Upscaler::Upscaler(int sourceWidth, int sourceHeight, int scale, UpscaleFilter filter, UpscaleKernels kernels)
+    : sourceWidth_(sourceWidth), sourceHeight_(sourceHeight), scale_(scale < 1 ? 1 : scale), filter_(filter),
+      fillSpan_(fillSpanScalar), darkenSpan_(darkenSpanScalar) {
+    // Pick the widest kernels this CPU supports unless a supported set was asked for
+    if(kernels == UpscaleKernels::Best || !supported(kernels))
+        kernels = supported(UpscaleKernels::Avx2) ? UpscaleKernels::Avx2
+            : supported(UpscaleKernels::Sse2) ? UpscaleKernels::Sse2 : UpscaleKernels::Scalar;
+#ifdef UPSCALER_SSE2
+    if(kernels == UpscaleKernels::Sse2) {
+        fillSpan_ = fillSpanSse2;
+        darkenSpan_ = darkenSpanSse2;
+    }
+#endif
+#ifdef UPSCALER_AVX2
+    if(kernels == UpscaleKernels::Avx2) {
+        fillSpan_ = fillSpanAvx2;
+        darkenSpan_ = darkenSpanAvx2;
+    }
+#endif
+    // Scale2x produces a 2x frame which is then replicated, so it only applies to even scales
+    if(filter_ == UpscaleFilter::Scale2x) {
+        if(scale_ % 2 != 0)
+            filter_ = UpscaleFilter::Nearest;
+        else
+            intermediate_.resize(sourceWidth_ * 2 * sourceHeight_ * 2);
+    }
+}
+
+// Width of the Upscaled Frame in Pixels
+int Upscaler::outputWidth() const {
+    return sourceWidth_ * scale_;
+}
+// Height of the Upscaled Frame in Pixels
+int Upscaler::outputHeight() const {
+    return sourceHeight_ * scale_;
+}
+
+// Upscale a Frame; Pitches are in Bytes
+void Upscaler::upscale(const uint32_t* source, int sourcePitch, uint32_t* destination, int destinationPitch) {
+    switch(filter_) {
+        case UpscaleFilter::Nearest:
+            replicate(source, sourcePitch, sourceWidth_, sourceHeight_, scale_, destination, destinationPitch, false);
+            break;
+        case UpscaleFilter::Scanline:
+            replicate(source, sourcePitch, sourceWidth_, sourceHeight_, scale_, destination, destinationPitch, true);
+            break;
+        case UpscaleFilter::Scale2x: {
+            scale2x(source, sourcePitch);
+            int intermediatePitch = sourceWidth_ * 2 * sizeof(uint32_t);
+            replicate(intermediate_.data(), intermediatePitch, sourceWidth_ * 2, sourceHeight_ * 2, scale_ / 2, destination, destinationPitch, false);
+            break;
+        }
+    }
+}
+
+/*
+    Nearest Integer Replication of an Arbitrary Frame
+    Each source row is expanded horizontally once, then the expanded row is copied down for the rest of its block
+    With scanlines enabled the last row of every block is darkened (only when the block is at least 2 rows tall)
+*/
+void Upscaler::replicate(const uint32_t* source, int sourcePitch, int width, int height, int scale, uint32_t* destination, int destinationPitch, bool scanlines) {
+    int sourceStride = sourcePitch / sizeof(uint32_t);
+    int destinationStride = destinationPitch / sizeof(uint32_t);
+    size_t rowBytes = width * scale * sizeof(uint32_t);
+
+    for(int y = 0; y < height; y++) {
+        const uint32_t* sourceRow = source + y * sourceStride;
+        uint32_t* blockRow = destination + y * scale * destinationStride;
+
+        // Expand the source row horizontally
+        for(int x = 0; x < width; x++)
+            fillSpan_(blockRow + x * scale, sourceRow[x], scale);
+        // Copy the expanded row down for the rest of the block
+        for(int r = 1; r < scale; r++)
+            memcpy(blockRow + r * destinationStride, blockRow, rowBytes);
+
+        if(scanlines && scale > 1)
+            darkenSpan_(blockRow + (scale - 1) * destinationStride, width * scale);
+    }
+}
+/*
+    Run Scale2x on the Source Frame into the Intermediate Buffer
+    Every source pixel P becomes a 2x2 block; each corner takes the colour of its two adjacent neighbours when they agree
+    and the opposite neighbours do not, otherwise P. Pixels past the frame edge are treated as copies of P.
+*/
+void Upscaler::scale2x(const uint32_t* source, int sourcePitch) {
+    int sourceStride = sourcePitch / sizeof(uint32_t);
+    int outputStride = sourceWidth_ * 2;
+
+    for(int y = 0; y < sourceHeight_; y++) {
+        const uint32_t* row = source + y * sourceStride;
+        const uint32_t* above = y > 0 ? row - sourceStride : row;
+        const uint32_t* below = y < sourceHeight_ - 1 ? row + sourceStride : row;
+        uint32_t* top = intermediate_.data() + (y * 2) * outputStride;
+        uint32_t* bottom = top + outputStride;
+
+        for(int x = 0; x < sourceWidth_; x++) {
+            uint32_t p = row[x];
+            uint32_t a = above[x];
+            uint32_t d = below[x];
+            uint32_t c = x > 0 ? row[x - 1] : p;
+            uint32_t b = x < sourceWidth_ - 1 ? row[x + 1] : p;
+
+            top[x * 2] = (c == a && c != d && a != b) ? a : p;
+            top[x * 2 + 1] = (a == b && a != c && b != d) ? b : p;
+            bottom[x * 2] = (d == c && d != b && c != a) ? c : p;
+            bottom[x * 2 + 1] = (b == d && b != a && d != c) ? d : p;
+        }
+    }
+}
+
+// Can This Build on This CPU Run the Kernel Set?
+bool Upscaler::supported(UpscaleKernels kernels) {
+    switch(kernels) {
+        case UpscaleKernels::Best:
+        case UpscaleKernels::Scalar:
+            return true;
+        case UpscaleKernels::Sse2:
+#ifdef UPSCALER_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case UpscaleKernels::Avx2:
+#ifdef UPSCALER_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+// Convert a Filter Name ("nearest", "scanline", "scale2x") to a Filter
+bool Upscaler::parseFilter(const char* name, UpscaleFilter& filter) {
+    if(strcmp(name, "nearest") == 0)
+        filter = UpscaleFilter::Nearest;
+    else if(strcmp(name, "scanline") == 0)
+        filter = UpscaleFilter::Scanline;
+    else if(strcmp(name, "scale2x") == 0)
+        filter = UpscaleFilter::Scale2x;
+    else
+        return false;
+    return true;
+}
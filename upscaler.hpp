@@ -0,0 +1,53 @@
+#ifndef UPSCALER_HPP
+#define UPSCALER_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Filters the Upscaler can apply when enlarging a frame
+enum class UpscaleFilter {
+    Nearest,                                                            // Plain integer pixel replication
+    Scanline,                                                           // Integer replication with the last row of every block darkened
+    Scale2x                                                             // EPX/Scale2x edge smoothing, followed by integer replication
+};
+
+// Sets of Pixel Kernels the Upscaler Can Run; Every Set Produces Identical Output
+enum class UpscaleKernels {
+    Best,                                                               // The Widest Set This CPU Supports
+    Scalar,                                                             // Plain C++, Available Everywhere
+    Sse2,                                                               // 128-bit SSE2, on x86 Builds With SSE2 Enabled
+    Avx2                                                                // 256-bit AVX2, on x86 CPUs That Report AVX2 at Runtime
+};
+
+/*
+    CPU-side upscaler for RGBA8888 frames
+    Has no SDL dependency so it can also produce upscaled frames headlessly (e.g. for thumbnails); it is part of
+    libchipndale.a. Scale2x only applies to even scales; with an odd scale the frame is replicated as with Nearest.
+*/
+class Upscaler {
+    private:
+        int sourceWidth_;                                               // Width of the Source Frame in Pixels
+        int sourceHeight_;                                              // Height of the Source Frame in Pixels
+        int scale_;                                                     // Integer Scale Factor Applied to Each Axis
+        UpscaleFilter filter_;                                          // Filter Used When Upscaling
+        std::vector<uint32_t> intermediate_;                            // Scratch Buffer for the 2x Output of Scale2x
+        void (*fillSpan_)(uint32_t*, uint32_t, int);                    // Fills a Run of Pixels With One Value, From the Chosen Kernel Set
+        void (*darkenSpan_)(uint32_t*, int);                            // Halves the Colour of a Run of Pixels, From the Chosen Kernel Set
+
+        void replicate(const uint32_t* source, int sourcePitch,         // Nearest Integer Replication of an Arbitrary Frame
+            int width, int height, int scale, uint32_t* destination, int destinationPitch, bool scanlines);
+        void scale2x(const uint32_t* source, int sourcePitch);          // Run Scale2x on the Source Frame into the Intermediate Buffer
+    public:
+        Upscaler(int sourceWidth, int sourceHeight, int scale,          // Creates an Upscaler for a Fixed Source Size and Scale
+            UpscaleFilter filter, UpscaleKernels kernels = UpscaleKernels::Best);
+
+        int outputWidth() const;                                        // Width of the Upscaled Frame in Pixels
+        int outputHeight() const;                                       // Height of the Upscaled Frame in Pixels
+        void upscale(const uint32_t* source, int sourcePitch,           // Upscale a Frame; Pitches are in Bytes
+            uint32_t* destination, int destinationPitch);
+
+        static bool parseFilter(const char* name, UpscaleFilter& filter); // Convert a Filter Name ("nearest", "scanline", "scale2x") to a Filter
+        static bool supported(UpscaleKernels kernels);                  // Can This Build on This CPU Run the Kernel Set?
+};
+
+#endif